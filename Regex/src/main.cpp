@@ -6,41 +6,54 @@
  *  https://en.wikipedia.org/wiki/ReDoS
  */
 
+#include "regex/regexAnalyzer.hpp"
+#include "regex/regexCache.hpp"
+#include "regex/regexMetrics.hpp"
+#include "regex/regexPool.hpp"
+#include "regex/regexSet.hpp"
+#include "regex/regexStream.hpp"
+
 #include <chrono>
-#include <future>
-#include <mutex>
+#include <format>
 #include <print>
-#include <regex>
-#include <thread>
+#include <span>
+#include <sstream>
+#include <vector>
 
 // -- Main Functions --
 
-// Global mutex to protect access to regex operation
-std::mutex g_regex_mutex;
-
 // Function checks for errors in the pattern that could be problematic
-auto checkRgx(std::string &pattern) -> bool {
+// (the warning, empty when the pattern looks safe)
+auto checkRgx(std::string_view pattern) -> std::string {
   if (pattern.empty()) {
-    std::println("Empty pattern!");
-    return false;
+    return "Empty pattern!";
   }
 
-  // Known problematic patterns for ReDoS
-  std::vector<std::regex> dangerous_patterns = {
-      std::regex(R"(\(.+\)\+)"),           // Groups with nested +: (a+)+
-      std::regex(R"(\(.+\)\*)"),           // Groups with nested *: (a*)*
-      std::regex(R"(\(.+\)\{.+\})"),       // Groups with quantifiers: (a+){2,}
-      std::regex(R"(\([^)]*\|[^)]*\)\*)"), // Alternation with * (a|a)*
-  };
-
-  for (const auto &dangerous : dangerous_patterns) {
-    if (std::regex_search(pattern, std::regex(dangerous))) {
-      std::println("Warning: Potentially dangerous pattern detected!");
-      return false;
-    }
+  // Time growing faster than the text on the matcher the pattern runs on
+  auto analysis = analyzePattern(pattern);
+  if (!analysis || analysis->effective() == Growth::Linear) {
+    return {}; // Invalid patterns are reported when compiled
   }
+  return std::format("Warning: {} backtracking ({})!",
+                     growthName(analysis->growth), analysis->reason);
+}
+
+// Compiled patterns and their check, shared by every search
+auto patterns() -> PatternCache & {
+  static PatternCache cache(checkRgx);
+  return cache;
+}
+
+// Counters and latencies of the searches made by find
+auto metrics() -> MetricsRegistry & {
+  static MetricsRegistry registry;
+  return registry;
+}
 
-  return true;
+// Workers of processMany, started on first use
+auto workers() -> ThreadPool & {
+  static ThreadPool pool;
+  return pool;
 }
 
 // Function that executes the Regex
@@ -48,59 +61,37 @@ auto find(std::string &text, std::string &pattern, std::string &response,
           std::chrono::milliseconds timeout_duration, bool check_pattern = true)
     -> bool {
 
-  if (check_pattern) {
-    if (!checkRgx(pattern)) {
-      std::println("Potentially problematic pattern!");
-      return false;
-    }
+  auto compiled = patterns().get(pattern);
+  if (check_pattern && !compiled->warning.empty()) {
+    std::println("{}", compiled->warning);
+    std::println("Potentially problematic pattern!");
+    return false;
   }
 
-  // Initialize protection
-  std::lock_guard<std::mutex> lock(g_regex_mutex);
-
-  // Time control
-  std::promise<std::string> promise_result;
-  std::future<std::string> future_result = promise_result.get_future();
-
-  std::jthread regex_thread([&](std::stop_token st) {
-    std::smatch m;
-    try {
-      auto rgx = std::regex(pattern);
-      auto found = std::regex_search(text, m, rgx);
-      if (found) {
-        // Match found, assign found value
-        promise_result.set_value(m.str(0));
-      } else {
-        // If nothing found, assign empty
-        promise_result.set_value({});
-      }
-    } catch (const std::regex_error &e) {
-      std::println("Regex error in jthread: {}", e.what());
-      promise_result.set_value({});
-    } catch (...) {
-      std::println("Unknown error in jthread.");
-      promise_result.set_value({});
-    }
-  });
+  const auto &rgx = compiled->regex;
+  if (!rgx) {
+    std::println("Regex error: {}", rgx.error());
+    return false;
+  }
 
-  // Wait for response
-  std::future_status status = future_result.wait_for(timeout_duration);
-  if (status == std::future_status::ready) {
-    // The regex operation finished within the timeout
-    std::string result = future_result.get();
-    // Handle response
-    response = result;
-    return !result.empty();
-  } else if (status == std::future_status::timeout) {
+  // The matcher checks the deadline itself and stops when it passes, no
+  // thread is left running
+  auto start = std::chrono::steady_clock::now();
+  auto result = rgx->search(text, Budget::after(timeout_duration));
+  metrics().record(pattern, result.status, text.size(),
+                   std::chrono::steady_clock::now() - start);
+  switch (result.status) {
+  case SearchStatus::Found:
+    response = text.substr(result.position, result.length);
+    return !response.empty();
+  case SearchStatus::Timeout:
     std::println("Regex operation timed out after {} ms!",
                  timeout_duration.count());
-    regex_thread.request_stop();
-    return false;
-  } else {
-    std::println("Regex operation did not finish or was deferred (unexpected "
-                 "with jthread).");
     return false;
+  case SearchStatus::NotFound:
+    break;
   }
+  return false;
 }
 
 // Function makes indirect call to the find function
@@ -115,6 +106,25 @@ auto process(std::string &text, std::string &pattern,
   return status_msg;
 }
 
+// A search of processMany
+struct Query {
+  std::string text;
+  std::string pattern;
+};
+
+// Function runs searches in parallel on the shared workers (results in the
+// order of the queries)
+auto processMany(std::span<Query> queries,
+                 std::chrono::milliseconds timeout_duration,
+                 bool check_pattern = true) -> std::vector<std::string> {
+  std::vector<std::string> results(queries.size());
+  workers().parallel_for(queries.size(), [&](size_t i) {
+    results[i] = process(queries[i].text, queries[i].pattern,
+                         timeout_duration, check_pattern);
+  });
+  return results;
+}
+
 // Function displays searches
 auto view(
     std::string text, std::string pattern,
@@ -125,6 +135,66 @@ auto view(
   std::println();
 }
 
+// Function displays searches run in parallel
+auto viewMany(
+    std::vector<Query> queries,
+    std::chrono::milliseconds timeout_duration = std::chrono::milliseconds(100),
+    bool check_pattern = true) {
+  auto statuses = processMany(queries, timeout_duration, check_pattern);
+  for (size_t i = 0; i < queries.size(); ++i) {
+    std::println("Input: {}\nPattern: {}\nStatus: {}", queries[i].text,
+                 queries[i].pattern, statuses[i]);
+    std::println();
+  }
+}
+
+// Function displays every match of several patterns, searched together
+auto viewSet(std::string text, const std::vector<std::string> &patterns,
+             std::chrono::milliseconds timeout_duration =
+                 std::chrono::milliseconds(100)) {
+  auto set = RegexSet::compile(patterns);
+  if (!set) {
+    std::println("Regex error: {}", set.error());
+    return;
+  }
+  auto result = set->scan(text, Budget::after(timeout_duration));
+  std::println("Input: {}", text);
+  for (const auto &match : result.matches) {
+    std::println("Pattern: {} -> {}", set->pattern(match.pattern),
+                 text.substr(match.position, match.length));
+  }
+  if (result.status == SearchStatus::Timeout) {
+    std::println("Regex operation timed out after {} ms!",
+                 timeout_duration.count());
+  } else if (result.matches.empty()) {
+    std::println("Status: No, nothing found!");
+  }
+  std::println();
+}
+
+// Function displays the matches of a search over a stream read by chunks
+auto viewStream(std::istream &input, std::string pattern,
+                StreamOptions options,
+                std::chrono::milliseconds timeout_duration =
+                    std::chrono::milliseconds(100)) {
+  auto rgx = Regex::compile(pattern);
+  if (!rgx) {
+    std::println("Regex error: {}", rgx.error());
+    return;
+  }
+  std::println("Pattern: {}", pattern);
+  for (const auto &match :
+       searchStream(*rgx, input, Budget::after(timeout_duration), options)) {
+    if (match.status == SearchStatus::Timeout) {
+      std::println("Regex operation timed out after {} ms!",
+                   timeout_duration.count());
+      break;
+    }
+    std::println("Offset {}: {}", match.offset, match.text);
+  }
+  std::println();
+}
+
 // --- Test ---
 void test() {
   std::string text =
@@ -167,12 +237,48 @@ void test() {
       {"(a+)+", std::string(20, 'a')},
       {"(a*)*", std::string(20, 'a')},
       {"(a|a)*", std::string(20, 'a')},
-      {"(a|b)*a", std::string(20, 'b') + "c"}};
+      {"(a|b)*a", std::string(20, 'b') + "c"},
+      {"((a+)+)\\1b", std::string(20, 'a')}}; // Backreference: backtracks
 
   for (const auto &[pattern, text] : redos_tests) {
     std::println("Testing ReDoS pattern: {}", pattern);
+    if (auto analysis = analyzePattern(pattern)) {
+      std::println("Backtracking: {}, run: {}", growthName(analysis->growth),
+                   analysis->automaton ? "automaton (linear)" : "backtracking");
+    }
     view(text, pattern, short_timeout);
   }
+
+  // Searches run side by side, each pattern compiled once
+  std::println("-- Parallel searches (shared workers) ---");
+  std::vector<Query> queries;
+  for (auto pattern : {"phone", "\\d+", "[a-z]+@[a-z.]+", "phone"}) {
+    queries.push_back({text, pattern});
+  }
+  viewMany(queries);
+  auto stats = patterns().stats();
+  std::println("Patterns compiled: {}, reused: {}", stats.misses, stats.hits);
+  std::println();
+
+  // One pass over the text for all the patterns
+  std::println("-- Multi-pattern scan ---");
+  viewSet(text, {"\\+\\d{2}\\s\\(\\d{2}\\)\\s\\d{4,5}-\\d{4}",
+                 "[a-z]+@[a-z]+(\\.[a-z]{2,3})+", "\\b\\d{2}\\b", "cpf",
+                 "my"});
+
+  // Matches across chunk boundaries are found in the overlap window
+  std::println("-- Streaming search (chunks of 16 bytes) ---");
+  std::istringstream log(text + '\n' + text);
+  viewStream(log, "\\d{4,5}-\\d{4}|[a-z]+@[a-z.]+[a-z]", {16, 32});
+
+  // What the searches above cost, the most time first
+  std::println("-- Metrics ---");
+  if (auto slowest = metrics().all(); !slowest.empty()) {
+    const auto &top = slowest.front();
+    std::println("Most time: {} ({} searches, p50 {}, p99 {}, max {})",
+                 top.pattern, top.searches, top.p50, top.p99, top.max);
+  }
+  std::println("{}", metrics().toJson());
 }
 
 // --- Main ---
@@ -0,0 +1,425 @@
+#include "regexAnalyzer.hpp"
+#include "regexProgram.hpp"
+
+#include <algorithm>
+#include <format>
+#include <unordered_set>
+
+namespace {
+
+// States of a comparison explored before giving up (and assuming overlap)
+constexpr size_t max_states = 1 << 18;
+
+// Capturing groups of a tree by number (nullptr at 0, the whole match)
+using Captures = std::vector<const Node *>;
+
+void collectGroups(const Node &node, Captures &captures) {
+  if (node.type == NodeType::Group && node.index > 0) {
+    captures[node.index] = &node;
+  }
+  for (const auto &child : node.children) {
+    collectGroups(child, captures);
+  }
+}
+
+// Function replaces each backreference by the body of its group: the texts
+// it can match are among the ones the group matches
+void inlineBackreferences(Node &node, const Captures &captures) {
+  while (node.type == NodeType::Backreference) { // The body can be one
+    node = captures[node.index]->children.front();
+  }
+  for (auto &child : node.children) {
+    inlineBackreferences(child, captures);
+  }
+}
+
+// Texts matched by a part of a tree: its instructions, with assertions
+// taken as matching anything and backreferences as their groups
+class Language {
+public:
+  Language(const Node &node, const Captures &captures) {
+    Ast ast;
+    ast.root = node;
+    ast.groups = captures.size() - 1;
+    inlineBackreferences(ast.root, captures);
+    if (auto compiled = compileProgram(ast)) {
+      program = std::move(*compiled);
+      closures.resize(program.code.size());
+    }
+  }
+
+  auto valid() const -> bool { return !program.code.empty(); }
+
+  // Function returns the instructions reading a byte, or Match, reached
+  // from 'pc' without reading
+  auto closure(size_t pc) -> const std::vector<size_t> & {
+    auto &reached = closures[pc];
+    if (!reached.empty()) {
+      return reached;
+    }
+    std::vector<bool> seen(program.code.size(), false);
+    std::vector<size_t> pending{pc};
+    while (!pending.empty()) {
+      auto next = pending.back();
+      pending.pop_back();
+      if (seen[next]) {
+        continue;
+      }
+      seen[next] = true;
+      const auto &instruction = program.code[next];
+      switch (instruction.op) {
+      case OpCode::Split:
+        pending.push_back(instruction.y);
+        pending.push_back(instruction.x);
+        break;
+      case OpCode::Jump:
+      case OpCode::Lookahead: // Its body reads nothing of the match
+      case OpCode::NegativeLookahead:
+        pending.push_back(instruction.x);
+        break;
+      case OpCode::Byte:
+      case OpCode::Set:
+      case OpCode::Match:
+        reached.push_back(next);
+        break;
+      default:
+        pending.push_back(next + 1);
+        break;
+      }
+    }
+    return reached;
+  }
+
+  auto matches(size_t pc) const -> bool {
+    return program.code[pc].op == OpCode::Match;
+  }
+
+  auto bytes(size_t pc) const -> ByteSet {
+    const auto &instruction = program.code[pc];
+    if (instruction.op == OpCode::Set) {
+      return program.sets[instruction.x];
+    }
+    ByteSet set;
+    set.set(instruction.byte);
+    return set;
+  }
+
+  auto size() const -> size_t { return program.code.size(); }
+
+private:
+  Program program;
+  std::vector<std::vector<size_t>> closures;
+};
+
+// Function checks if a non-empty text is matched by 'a' and by 'b' (both
+// run side by side on the same bytes)
+auto overlap(Language &a, Language &b) -> bool {
+  if (!a.valid() || !b.valid()) {
+    return true; // Unknown, assume the worst
+  }
+  struct State {
+    size_t a;
+    size_t b;
+    bool read;
+  };
+  std::unordered_set<size_t> seen;
+  std::vector<State> pending;
+  auto push = [&](const State &state) {
+    if (seen.insert((state.a * b.size() + state.b) * 2 + state.read).second) {
+      pending.push_back(state);
+    }
+  };
+  for (auto pa : a.closure(0)) {
+    for (auto pb : b.closure(0)) {
+      push({pa, pb, false});
+    }
+  }
+
+  while (!pending.empty()) {
+    if (seen.size() > max_states) {
+      return true;
+    }
+    auto state = pending.back();
+    pending.pop_back();
+    bool a_done = a.matches(state.a);
+    bool b_done = b.matches(state.b);
+    if (a_done && b_done && state.read) {
+      return true;
+    }
+    if (a_done || b_done || (a.bytes(state.a) & b.bytes(state.b)).none()) {
+      continue;
+    }
+    for (auto pa : a.closure(state.a + 1)) {
+      for (auto pb : b.closure(state.b + 1)) {
+        push({pa, pb, true});
+      }
+    }
+  }
+  return false;
+}
+
+// Function checks if a text is split in two ways into non-empty matches of
+// 'body': two runs of the repetition on the same bytes, ending iterations
+// at different places, then one together
+auto ambiguousIterations(Language &body) -> bool {
+  if (!body.valid()) {
+    return true;
+  }
+  struct State {
+    size_t a;
+    size_t b;
+    bool read_a; // The current iteration of each run read a byte
+    bool read_b;
+    bool split; // The runs ended an iteration at different places
+  };
+  std::unordered_set<size_t> seen;
+  std::vector<State> pending;
+  auto push = [&](const State &state) {
+    auto key = (state.a * body.size() + state.b) * 8 + state.read_a * 4 +
+               state.read_b * 2 + state.split;
+    if (seen.insert(key).second) {
+      pending.push_back(state);
+    }
+  };
+  for (auto pa : body.closure(0)) {
+    for (auto pb : body.closure(0)) {
+      push({pa, pb, false, false, false});
+    }
+  }
+
+  while (!pending.empty()) {
+    if (seen.size() > max_states) {
+      return true;
+    }
+    auto state = pending.back();
+    pending.pop_back();
+    bool a_done = body.matches(state.a) && state.read_a;
+    bool b_done = body.matches(state.b) && state.read_b;
+    if (a_done && b_done && state.split) {
+      return true;
+    }
+    // Next iteration of one run while the other goes on reading, or of both
+    for (auto next : body.closure(0)) {
+      if (a_done && !body.matches(state.b)) {
+        push({next, state.b, false, state.read_b, true});
+      }
+      if (b_done && !body.matches(state.a)) {
+        push({state.a, next, state.read_a, false, true});
+      }
+    }
+    if (a_done && b_done) {
+      for (auto pa : body.closure(0)) {
+        for (auto pb : body.closure(0)) {
+          push({pa, pb, false, false, state.split});
+        }
+      }
+    }
+    if (body.matches(state.a) || body.matches(state.b) ||
+        (body.bytes(state.a) & body.bytes(state.b)).none()) {
+      continue;
+    }
+    for (auto pa : body.closure(state.a + 1)) {
+      for (auto pb : body.closure(state.b + 1)) {
+        push({pa, pb, true, true, state.split});
+      }
+    }
+  }
+  return false;
+}
+
+// Function lists the parts matched one after the other, groups opened
+void flatten(const Node &node, std::vector<const Node *> &items) {
+  if (node.type == NodeType::Group) {
+    flatten(node.children.front(), items);
+  } else if (node.type == NodeType::Concat) {
+    for (const auto &child : node.children) {
+      flatten(child, items);
+    }
+  } else {
+    items.push_back(&node);
+  }
+}
+
+// Function returns how many choices a repetition makes of where a text is
+// split: one for its length, plus one per iteration that may be empty or
+// not, (a?){n} (only the first 'min': an empty one after them stops it)
+auto splits(const Node &item) -> size_t {
+  if (item.type != NodeType::Repeat || item.max < 2) {
+    return 0;
+  }
+  if (item.max == unbounded) {
+    return 1;
+  }
+  size_t varying = item.min < item.max ? 1 : 0;
+  if (matchesEmpty(item.children.front())) {
+    return item.min + varying;
+  }
+  return varying;
+}
+
+class Analyzer {
+public:
+  explicit Analyzer(const Ast &ast) : captures(ast.groups + 1, nullptr) {
+    collectGroups(ast.root, captures);
+  }
+
+  // Function checks a tree, 'loop' the innermost repetition around it
+  void visit(const Node &node, const Node *loop) {
+    switch (node.type) {
+    case NodeType::Repeat:
+      if (node.max >= 2) {
+        checkLoop(node);
+        loop = &node;
+      }
+      break;
+    case NodeType::Alternation:
+      if (loop != nullptr) {
+        checkAlternation(node, *loop);
+      }
+      break;
+    case NodeType::Concat: {
+      std::vector<const Node *> items;
+      flatten(node, items);
+      if (auto chain = longestChain(items); chain > 1) {
+        report(Growth::Polynomial, chain,
+               "repetitions one after the other match a same text");
+      }
+      break;
+    }
+    default:
+      break;
+    }
+    for (const auto &child : node.children) {
+      visit(child, loop);
+    }
+  }
+
+  Analysis analysis;
+
+private:
+  // Function keeps the largest growth found
+  void report(Growth growth, size_t degree, std::string reason) {
+    if (growth < analysis.growth ||
+        (growth == analysis.growth && degree <= analysis.degree)) {
+      return;
+    }
+    analysis.growth = growth;
+    analysis.degree = degree;
+    analysis.reason = std::move(reason);
+  }
+
+  // Ambiguous repetitions: exponential, or n^max when counted
+  void reportLoop(const Node &loop, std::string_view what) {
+    if (loop.max == unbounded) {
+      report(Growth::Exponential, 1, std::string(what));
+    } else {
+      report(Growth::Polynomial, loop.max,
+             std::format("{} (counted, up to {} times)", what, loop.max));
+    }
+  }
+
+  void checkLoop(const Node &loop) {
+    if (auto ways = splits(loop); loop.max != unbounded && ways > 1) {
+      report(Growth::Polynomial, ways,
+             "iterations of a counted repetition each match the empty "
+             "string or not");
+    }
+
+    Language body(loop.children.front(), captures);
+    if (ambiguousIterations(body)) {
+      reportLoop(loop, "a text is split into iterations of a repetition in "
+                       "several ways");
+      return;
+    }
+
+    // The end of an iteration and the start of the next, (\s*,\s*)*
+    std::vector<const Node *> items;
+    flatten(loop.children.front(), items);
+    flatten(loop.children.front(), items);
+    if (longestChain(items) > 1) {
+      reportLoop(loop, "repetitions in consecutive iterations of a "
+                       "repetition match a same text");
+    }
+  }
+
+  void checkAlternation(const Node &alternation, const Node &loop) {
+    std::vector<Language> branches;
+    for (const auto &child : alternation.children) {
+      branches.emplace_back(child, captures);
+    }
+    for (size_t i = 0; i < branches.size(); ++i) {
+      for (auto j = i + 1; j < branches.size(); ++j) {
+        if (overlap(branches[i], branches[j])) {
+          reportLoop(loop, "an alternation inside a repetition has branches "
+                           "matching a same text");
+          return;
+        }
+      }
+    }
+  }
+
+  // Function returns the most repetitions one after the other matching a
+  // same text, with only parts they can also match between them (the text
+  // is shared between them in n ways each), counted ones by their splits
+  auto longestChain(const std::vector<const Node *> &items) -> size_t {
+    struct Open {
+      Language language;
+      size_t chain; // Overlapping repetitions ending with this one
+    };
+    std::vector<Open> open;
+    size_t longest = 1;
+    for (const auto *item : items) {
+      if (auto ways = splits(*item); ways > 0) {
+        Language language(*item, captures);
+        size_t chain = ways;
+        for (auto &previous : open) {
+          if (overlap(previous.language, language)) {
+            chain = std::max(chain, previous.chain + ways);
+          }
+        }
+        longest = std::max(longest, chain);
+        open.push_back({std::move(language), chain});
+      } else if (!matchesEmpty(*item)) {
+        Language language(*item, captures);
+        std::erase_if(open, [&](Open &previous) {
+          return !overlap(previous.language, language);
+        });
+      }
+    }
+    return longest;
+  }
+
+  Captures captures;
+};
+
+} // namespace
+
+auto growthName(Growth growth) -> std::string_view {
+  switch (growth) {
+  case Growth::Linear:
+    return "linear";
+  case Growth::Polynomial:
+    return "polynomial";
+  case Growth::Exponential:
+    return "exponential";
+  }
+  return "unknown";
+}
+
+auto analyzePattern(const Ast &ast) -> Analysis {
+  Analyzer analyzer(ast);
+  analyzer.visit(ast.root, nullptr);
+  auto analysis = std::move(analyzer.analysis);
+  analysis.automaton = !needsBacktracking(ast.root);
+  return analysis;
+}
+
+auto analyzePattern(std::string_view pattern)
+    -> std::expected<Analysis, std::string> {
+  auto ast = parsePattern(pattern);
+  if (!ast) {
+    return std::unexpected(std::format("{} at position {}", ast.error().message,
+                                       ast.error().position));
+  }
+  return analyzePattern(*ast);
+}
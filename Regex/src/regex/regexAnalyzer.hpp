@@ -0,0 +1,50 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Static analysis of a pattern: how the time of a backtracking matcher can
+ * grow with the length of the text, read from the tree of the pattern.
+ *
+ * - Exponential: a repetition can match the same text in several ways, so
+ *   the ways multiply with each iteration. A text splits into iterations
+ *   in several ways, (a+)+ or (a|aa)*, or the repetition holds an
+ *   alternation whose branches match a same text, (a|a)*.
+ * - Polynomial: repetitions one after the other share some text, \d+\d+ or
+ *   .*x.*, so the split between them is tried at every position. Counted
+ *   repetitions count once per choice they make: (a?){20} counts 20 times,
+ *   each iteration may be empty or not.
+ *
+ * Languages are compared on the instructions of the parts, so "overlap"
+ * means an actual common text, not a common first byte. Assertions are
+ * ignored and a backreference is taken as any text its group can match,
+ * which can only report more growth.
+ */
+#pragma once
+
+#include "regexParser.hpp"
+
+#include <expected>
+#include <string>
+
+// Worst-case growth of the time with the length of the text
+enum class Growth { Linear, Polynomial, Exponential };
+
+struct Analysis {
+  Growth growth = Growth::Linear; // With a backtracking matcher
+  size_t degree = 1;              // Polynomial: time grows as n^degree
+  std::string reason;             // What causes the growth, empty if linear
+  bool automaton = true; // Runs on the automata: linear whatever 'growth'
+
+  // Function returns the growth of the matcher the pattern runs on
+  auto effective() const -> Growth {
+    return automaton ? Growth::Linear : growth;
+  }
+};
+
+auto growthName(Growth growth) -> std::string_view;
+
+// Function analyzes a parsed pattern
+auto analyzePattern(const Ast &ast) -> Analysis;
+
+// Function parses and analyzes a pattern (error message if it is invalid)
+auto analyzePattern(std::string_view pattern)
+    -> std::expected<Analysis, std::string>;
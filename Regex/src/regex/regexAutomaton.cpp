@@ -0,0 +1,479 @@
+#include "regexAutomaton.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <unordered_set>
+
+namespace {
+
+constexpr size_t unset = static_cast<size_t>(-1);
+
+// The DFA starts over when it holds more states than this
+constexpr size_t max_dfa_states = 2048;
+
+auto atWordBoundary(std::string_view text, size_t sp) -> bool {
+  bool before =
+      sp > 0 && isWordByte(static_cast<unsigned char>(text[sp - 1]));
+  bool after =
+      sp < text.size() && isWordByte(static_cast<unsigned char>(text[sp]));
+  return before != after;
+}
+
+auto consumes(const Instruction &instruction, unsigned char c,
+              const Program &program) -> bool {
+  if (instruction.op == OpCode::Byte) {
+    return instruction.byte == c;
+  }
+  return instruction.op == OpCode::Set && program.sets[instruction.x].test(c);
+}
+
+// Threads of one position, in order of preference, each with its captures
+// (sparse set: constant time insert, lookup and clear)
+class ThreadList {
+public:
+  ThreadList(size_t size, size_t width, size_t marks)
+      : sparse(size), captures(size * width), width(width), stride(marks + 1) {
+  }
+
+  // Function records that a thread reached 'pc' inside 'fresh' loops whose
+  // iteration began at this position (false when one already did). Those
+  // loops are the innermost ones around 'pc': their count decides which
+  // Progress instructions fail, so it is part of the state of the thread.
+  auto visit(size_t pc, size_t fresh) -> bool {
+    if (fresh > 0) {
+      return revisits.insert(pc * stride + fresh).second;
+    }
+    auto i = sparse[pc];
+    if (i < dense.size() && dense[i] == pc) {
+      return false;
+    }
+    sparse[pc] = static_cast<uint32_t>(dense.size());
+    dense.push_back(static_cast<uint32_t>(pc));
+    return true;
+  }
+
+  auto at(size_t pc) -> std::span<size_t> {
+    return {captures.data() + pc * width, width};
+  }
+
+  void clear() {
+    dense.clear();
+    if (!revisits.empty()) {
+      revisits.clear();
+    }
+  }
+
+  std::vector<uint32_t> dense;
+
+private:
+  std::vector<uint32_t> sparse;
+  std::vector<size_t> captures;
+  std::unordered_set<size_t> revisits;
+  size_t width;
+  size_t stride;
+};
+
+class PikeVm {
+public:
+  PikeVm(const Program &program, std::string_view text, const Budget &budget)
+      : program(program), text(text), meter(budget),
+        width(program.slots + program.marks),
+        current(program.code.size(), width, program.marks),
+        next(program.code.size(), width, program.marks),
+        scratch(width, unset) {}
+
+  auto search(size_t from) -> SearchResult {
+    bool matched = false;
+    std::vector<size_t> best;
+    for (auto sp = from; sp <= text.size(); ++sp) {
+      // A later start is less preferred than the threads already running
+      if (!matched && (!program.anchored || sp == 0)) {
+        if (current.dense.empty() && !program.anchored) {
+          // No thread running: go to where a match can start
+          sp = program.prefilter.next(text, sp);
+          if (sp == std::string_view::npos) {
+            break;
+          }
+        }
+        std::ranges::fill(scratch, unset);
+        add(current, 0, sp);
+      }
+      if (current.dense.empty()) {
+        break; // Matched, or anchored and past the start
+      }
+      if (!meter.tick(current.dense.size())) {
+        return {SearchStatus::Timeout, 0, 0, meter.steps()};
+      }
+
+      for (auto pc : current.dense) {
+        const auto &instruction = program.code[pc];
+        if (instruction.op == OpCode::Match) {
+          // Threads after this one are less preferred, they are dropped
+          auto captures = current.at(pc);
+          best.assign(captures.begin(), captures.end());
+          matched = true;
+          break;
+        }
+        // A preferred thread wants a byte past the end: more text could
+        // change the result
+        hitEnd = hitEnd || sp == text.size();
+        if (sp < text.size() &&
+            consumes(instruction, static_cast<unsigned char>(text[sp]),
+                     program)) {
+          std::ranges::copy(current.at(pc), scratch.begin());
+          add(next, pc + 1, sp + 1);
+        }
+      }
+      std::swap(current, next);
+      next.clear();
+    }
+    if (!matched) {
+      return {SearchStatus::NotFound, 0, 0, meter.steps(), hitEnd};
+    }
+    return {SearchStatus::Found, best[0], best[1] - best[0], meter.steps(),
+            hitEnd};
+  }
+
+private:
+  struct Entry {
+    bool restore; // Else a branch to explore
+    size_t a;     // pc, or slot to restore
+    size_t b;     // Value to restore, or fresh loops of the branch
+  };
+
+  // Function adds the thread at 'pc' and every one it reaches without
+  // reading, the captures taken from 'scratch' (left unchanged)
+  void add(ThreadList &list, size_t pc, size_t sp) {
+    stack.push_back({false, pc, 0});
+    while (!stack.empty()) {
+      auto entry = stack.back();
+      stack.pop_back();
+      if (entry.restore) {
+        scratch[entry.a] = entry.b;
+      } else {
+        fresh = entry.b;
+        follow(list, entry.a, sp);
+      }
+    }
+  }
+
+  void follow(ThreadList &list, size_t pc, size_t sp) {
+    while (true) {
+      const auto &instruction = program.code[pc];
+      if (sp == text.size() && (instruction.op == OpCode::LineEnd ||
+                                instruction.op == OpCode::WordBoundary ||
+                                instruction.op == OpCode::NotWordBoundary)) {
+        hitEnd = true; // Decided by the end of the text
+      }
+      // Threads waiting for a byte lose their fresh loops when they read it
+      bool waits = instruction.op == OpCode::Byte ||
+                   instruction.op == OpCode::Set ||
+                   instruction.op == OpCode::Match;
+      if (!list.visit(pc, waits ? 0 : fresh)) {
+        return;
+      }
+      switch (instruction.op) {
+      case OpCode::Jump:
+        pc = instruction.x;
+        continue;
+      case OpCode::Split:
+        stack.push_back({false, instruction.y, fresh});
+        pc = instruction.x;
+        continue;
+      case OpCode::Save:
+        save(instruction.x, sp);
+        break;
+      case OpCode::Mark:
+        if (scratch[program.slots + instruction.x] != sp) {
+          ++fresh;
+        }
+        save(program.slots + instruction.x, sp);
+        break;
+      case OpCode::Progress:
+        if (scratch[program.slots + instruction.x] == sp) {
+          return;
+        }
+        break;
+      case OpCode::LineBegin:
+        if (sp != 0) {
+          return;
+        }
+        break;
+      case OpCode::LineEnd:
+        if (sp != text.size()) {
+          return;
+        }
+        break;
+      case OpCode::WordBoundary:
+        if (!atWordBoundary(text, sp)) {
+          return;
+        }
+        break;
+      case OpCode::NotWordBoundary:
+        if (atWordBoundary(text, sp)) {
+          return;
+        }
+        break;
+      default:
+        // Byte, Set, Match: the thread waits here with its captures
+        std::ranges::copy(scratch, list.at(pc).begin());
+        return;
+      }
+      ++pc;
+    }
+  }
+
+  void save(size_t slot, size_t sp) {
+    stack.push_back({true, slot, scratch[slot]});
+    scratch[slot] = sp;
+  }
+
+  const Program &program;
+  std::string_view text;
+  StepMeter meter;
+  size_t width;
+  ThreadList current;
+  ThreadList next;
+  std::vector<size_t> scratch;
+  std::vector<Entry> stack;
+  size_t fresh = 0; // Loops of the thread followed whose iteration began here
+  bool hitEnd = false;
+};
+
+// States are sets of NFA instructions waiting for a byte (or Match, or $),
+// built on first use; a cached transition costs one table lookup
+class LazyDfa {
+public:
+  LazyDfa(const Program &program, std::string_view text, const Budget &budget)
+      : program(program), text(text), meter(budget),
+        seen(program.code.size(), 0) {
+    if (program.prefilter.active && !program.anchored) {
+      closure({0}, false, idle);
+      std::ranges::sort(idle);
+    }
+  }
+
+  // Function runs until 'found' returns true, called at each position
+  // where a match ends with the instructions reached (Match among them)
+  template <typename Found>
+  auto scan(size_t from, Found found) -> SearchResult {
+    if (program.anchored && from > 0) {
+      return {SearchStatus::NotFound, 0, 0, meter.steps()};
+    }
+    std::vector<uint32_t> set;
+    closure({0}, from == 0, set);
+    auto state = intern(std::move(set));
+    for (auto sp = from;; ++sp) {
+      if (states[state].idle) {
+        // Only a new match is pending: go to where one can start
+        sp = program.prefilter.next(text, sp);
+        if (sp == std::string_view::npos) {
+          break;
+        }
+      }
+      if (states[state].matches && found(states[state].pcs)) {
+        return {SearchStatus::Found, sp, 0, meter.steps()};
+      }
+      if (sp == text.size()) {
+        if (found(endReached(states[state].pcs, sp == 0))) {
+          return {SearchStatus::Found, sp, 0, meter.steps()};
+        }
+        break;
+      }
+      auto c = static_cast<unsigned char>(text[sp]);
+      auto target = states[state].next[c];
+      if (target < 0) {
+        if (!meter.tick(states[state].pcs.size())) {
+          return {SearchStatus::Timeout, 0, 0, meter.steps()};
+        }
+        target = step(state, c);
+      } else if (!meter.tick()) {
+        return {SearchStatus::Timeout, 0, 0, meter.steps()};
+      }
+      state = static_cast<size_t>(target);
+    }
+    return {SearchStatus::NotFound, 0, 0, meter.steps()};
+  }
+
+private:
+  struct State {
+    std::vector<uint32_t> pcs; // Sorted
+    bool matches = false;
+    bool idle = false; // Only the start of a match, prefilter enabled
+    std::array<int32_t, 256> next;
+  };
+
+  // Function adds to 'set' the instructions reached from 'seeds' without
+  // reading ($ is kept pending unless 'at_end': only known at the end)
+  void closure(std::vector<uint32_t> seeds, bool at_start,
+               std::vector<uint32_t> &set, bool at_end = false) {
+    if (++generation == 0) {
+      std::ranges::fill(seen, 0);
+      generation = 1;
+    }
+    auto &pending = seeds;
+    while (!pending.empty()) {
+      auto pc = pending.back();
+      pending.pop_back();
+      if (seen[pc] == generation) {
+        continue;
+      }
+      seen[pc] = generation;
+      const auto &instruction = program.code[pc];
+      switch (instruction.op) {
+      case OpCode::Jump:
+        pending.push_back(static_cast<uint32_t>(instruction.x));
+        break;
+      case OpCode::Split:
+        pending.push_back(static_cast<uint32_t>(instruction.y));
+        pending.push_back(static_cast<uint32_t>(instruction.x));
+        break;
+      case OpCode::LineBegin:
+        if (at_start) {
+          pending.push_back(pc + 1);
+        }
+        break;
+      case OpCode::LineEnd:
+        if (at_end) {
+          pending.push_back(pc + 1);
+        } else {
+          set.push_back(pc);
+        }
+        break;
+      case OpCode::Save:
+      case OpCode::Mark:
+      case OpCode::Progress: // Empty iterations do not change what matches
+        pending.push_back(pc + 1);
+        break;
+      default: // Byte, Set, Match
+        set.push_back(pc);
+        break;
+      }
+    }
+  }
+
+  // Function returns the Match instructions a pending $ leads to at the end
+  // of the text
+  auto endReached(const std::vector<uint32_t> &pcs, bool at_start)
+      -> std::vector<uint32_t> {
+    std::vector<uint32_t> seeds;
+    for (auto pc : pcs) {
+      if (program.code[pc].op == OpCode::LineEnd) {
+        seeds.push_back(pc);
+      }
+    }
+    std::vector<uint32_t> reached;
+    if (!seeds.empty()) {
+      closure(std::move(seeds), at_start, reached, true);
+      std::erase_if(reached, [&](uint32_t pc) {
+        return program.code[pc].op != OpCode::Match;
+      });
+    }
+    return reached;
+  }
+
+  auto step(size_t from, unsigned char c) -> int32_t {
+    std::vector<uint32_t> seeds;
+    for (auto pc : states[from].pcs) {
+      if (consumes(program.code[pc], c, program)) {
+        seeds.push_back(pc + 1);
+      }
+    }
+    if (!program.anchored) {
+      seeds.push_back(0); // A match may also start after this byte
+    }
+    std::vector<uint32_t> set;
+    closure(std::move(seeds), false, set);
+
+    if (states.size() >= max_dfa_states) {
+      // Start over rather than grow without bound
+      auto keep = std::move(states[from]);
+      states.clear();
+      index.clear();
+      from = intern(std::move(keep.pcs));
+    }
+    auto target = static_cast<int32_t>(intern(std::move(set)));
+    states[from].next[c] = target;
+    return target;
+  }
+
+  auto intern(std::vector<uint32_t> set) -> size_t {
+    std::ranges::sort(set);
+    auto [it, inserted] = index.try_emplace(set, states.size());
+    if (inserted) {
+      State state;
+      state.matches = std::ranges::any_of(set, [&](uint32_t pc) {
+        return program.code[pc].op == OpCode::Match;
+      });
+      state.idle = !idle.empty() && set == idle;
+      state.pcs = std::move(set);
+      state.next.fill(-1);
+      states.push_back(std::move(state));
+    }
+    return it->second;
+  }
+
+  const Program &program;
+  std::string_view text;
+  StepMeter meter;
+  std::vector<State> states;
+  std::map<std::vector<uint32_t>, size_t> index;
+  std::vector<uint32_t> seen;
+  uint32_t generation = 0;
+  std::vector<uint32_t> idle; // State where no match is under way (sorted)
+};
+
+} // namespace
+
+auto pikeSearch(const Program &program, std::string_view text,
+                const Budget &budget, size_t from) -> SearchResult {
+  if (from > text.size()) {
+    return {};
+  }
+  return PikeVm(program, text, budget).search(from);
+}
+
+auto dfaSupports(const Program &program) -> bool {
+  return !program.backtracking &&
+         std::ranges::none_of(program.code, [](const Instruction &i) {
+           return i.op == OpCode::WordBoundary ||
+                  i.op == OpCode::NotWordBoundary;
+         });
+}
+
+auto dfaScan(const Program &program, std::string_view text,
+             const Budget &budget, size_t from) -> SearchResult {
+  if (from > text.size()) {
+    return {};
+  }
+  return LazyDfa(program, text, budget)
+      .scan(from, [](const std::vector<uint32_t> &reached) {
+        return !reached.empty();
+      });
+}
+
+auto dfaScanJoined(const Program &program, std::string_view text,
+                   const Budget &budget, std::vector<bool> &matched)
+    -> SearchResult {
+  auto left = static_cast<size_t>(std::ranges::count(matched, false));
+  auto result = LazyDfa(program, text, budget)
+                    .scan(0, [&](const std::vector<uint32_t> &reached) {
+                      for (auto pc : reached) {
+                        const auto &instruction = program.code[pc];
+                        if (instruction.op == OpCode::Match &&
+                            !matched[instruction.x]) {
+                          matched[instruction.x] = true;
+                          --left;
+                        }
+                      }
+                      return left == 0;
+                    });
+  if (result.status == SearchStatus::NotFound &&
+      std::ranges::find(matched, true) != matched.end()) {
+    result.status = SearchStatus::Found; // Not all of them
+  }
+  return result;
+}
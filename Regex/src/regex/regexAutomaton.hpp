@@ -0,0 +1,35 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Matchers that never backtrack, for patterns without backreferences or
+ * lookahead. The Pike VM (Thompson NFA simulation) moves every thread of the
+ * pattern one byte at a time, each instruction at most once per position
+ * (and per depth of the loops around it that can iterate empty), so a
+ * search costs O(text x pattern) whatever the pattern: (a+)+ is as cheap
+ * as a+. The lazy DFA builds sets of NFA states only as the text
+ * reaches them, then follows a table; it tells whether there is a match at
+ * all, which is the common answer on large texts.
+ */
+#pragma once
+
+#include "regexEngine.hpp"
+
+// Function finds the leftmost match at or after 'from', with the same
+// preference as the backtracking matcher
+auto pikeSearch(const Program &program, std::string_view text,
+                const Budget &budget, size_t from) -> SearchResult;
+
+// Function checks if the lazy DFA can run a program (no \b, \B)
+auto dfaSupports(const Program &program) -> bool;
+
+// Function checks if a match starts at or after 'from' (Found: 'position'
+// is where the first match to complete ends)
+auto dfaScan(const Program &program, std::string_view text,
+             const Budget &budget, size_t from) -> SearchResult;
+
+// Function marks in 'matched' (one per program joined, see joinPrograms)
+// the programs that match somewhere in the text, in one pass that stops
+// once all of them did
+auto dfaScanJoined(const Program &program, std::string_view text,
+                   const Budget &budget, std::vector<bool> &matched)
+    -> SearchResult;
@@ -0,0 +1,41 @@
+#include "regexCache.hpp"
+
+#include <algorithm>
+
+PatternCache::PatternCache(Check check, size_t capacity)
+    : check(std::move(check)), capacity(std::max<size_t>(capacity, 1)) {}
+
+auto PatternCache::get(std::string_view pattern)
+    -> std::shared_ptr<const CompiledPattern> {
+  {
+    std::lock_guard lock(mutex);
+    auto it = index.find(pattern);
+    if (it != index.end()) {
+      ++hits;
+      entries.splice(entries.begin(), entries, it->second);
+      return it->second->compiled;
+    }
+    ++misses;
+  }
+
+  // Compile outside the lock, searches with other patterns are not blocked
+  auto compiled = std::make_shared<const CompiledPattern>(
+      CompiledPattern{Regex::compile(pattern), check(pattern)});
+
+  std::lock_guard lock(mutex);
+  if (auto it = index.find(pattern); it != index.end()) {
+    return it->second->compiled; // Another caller compiled it first
+  }
+  entries.push_front({std::string(pattern), compiled});
+  index.emplace(entries.front().pattern, entries.begin());
+  if (entries.size() > capacity) {
+    index.erase(entries.back().pattern);
+    entries.pop_back();
+  }
+  return compiled;
+}
+
+auto PatternCache::stats() const -> PatternCacheStats {
+  std::lock_guard lock(mutex);
+  return {hits, misses, entries.size(), capacity};
+}
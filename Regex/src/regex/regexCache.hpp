@@ -0,0 +1,65 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Compiled patterns kept by their text: a pattern searched again is neither
+ * parsed nor checked again. Entries are shared and immutable, so any number
+ * of threads search with the same one; past the capacity the least recently
+ * used is dropped.
+ */
+#pragma once
+
+#include "regexEngine.hpp"
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// A pattern as compiled once, with the verdict of its safety check
+struct CompiledPattern {
+  std::expected<Regex, std::string> regex; // Error message when invalid
+  std::string warning;                     // Why it is unsafe, empty if safe
+};
+
+// Counters of a PatternCache
+struct PatternCacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t size = 0;
+  size_t capacity = 0;
+};
+
+class PatternCache {
+public:
+  // Function tells why a pattern is unsafe (empty when it is not)
+  using Check = std::function<std::string(std::string_view)>;
+
+  // At most 'capacity' patterns are kept (at least one)
+  explicit PatternCache(Check check, size_t capacity = 256);
+
+  PatternCache(const PatternCache &) = delete;
+  auto operator=(const PatternCache &) -> PatternCache & = delete;
+
+  // Function returns the compiled pattern, compiled and checked only when
+  // not cached
+  auto get(std::string_view pattern) -> std::shared_ptr<const CompiledPattern>;
+
+  auto stats() const -> PatternCacheStats;
+
+private:
+  using Compiled = std::shared_ptr<const CompiledPattern>;
+
+  struct Entry {
+    std::string pattern; // Owns the text the index points to
+    Compiled compiled;
+  };
+
+  Check check;
+  size_t capacity;
+  mutable std::mutex mutex;
+  std::list<Entry> entries; // Most recently used first
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+  size_t hits = 0;
+  size_t misses = 0;
+};
@@ -0,0 +1,265 @@
+#include "regexEngine.hpp"
+#include "regexAutomaton.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace {
+
+constexpr size_t unset = static_cast<size_t>(-1);
+
+// Backtracking matcher over a program: pending branches and the values to
+// restore when going back are kept on an explicit stack, not the call stack
+class Backtracker {
+public:
+  enum class Outcome { Matched, Failed, Timeout };
+
+  Backtracker(const Program &program, std::string_view text,
+              const Budget &budget)
+      : program(program), text(text), meter(budget),
+        slots(program.slots, unset), marks(program.marks, unset) {}
+
+  // Runs the program from 'pc' with the text at 'sp'
+  auto run(size_t pc, size_t sp) -> Outcome {
+    auto base = stack.size();
+    stack.push_back({Frame::Branch, pc, sp});
+    while (stack.size() > base) {
+      auto frame = stack.back();
+      stack.pop_back();
+      switch (frame.kind) {
+      case Frame::Slot:
+        slots[frame.a] = frame.b;
+        continue;
+      case Frame::Mark:
+        marks[frame.a] = frame.b;
+        continue;
+      case Frame::Branch:
+        break;
+      }
+      auto outcome = thread(frame.a, frame.b);
+      if (outcome != Outcome::Failed) {
+        return outcome;
+      }
+    }
+    return Outcome::Failed;
+  }
+
+  auto steps() const -> size_t { return meter.steps(); }
+
+  // Something was decided at the end of the text (see SearchResult)
+  auto hitEnd() const -> bool { return atEnd; }
+
+  // Position recorded in a capture slot (0, 1: the match)
+  auto slot(size_t index) const -> size_t { return slots[index]; }
+
+private:
+  struct Frame {
+    enum Kind { Branch, Slot, Mark } kind;
+    size_t a; // pc, slot or mark
+    size_t b; // position, or value to restore
+  };
+
+  auto atWordBoundary(size_t sp) const -> bool {
+    bool before =
+        sp > 0 && isWordByte(static_cast<unsigned char>(text[sp - 1]));
+    bool after =
+        sp < text.size() && isWordByte(static_cast<unsigned char>(text[sp]));
+    return before != after;
+  }
+
+  // Follows one path until it fails (alternatives pushed on the stack)
+  auto thread(size_t pc, size_t sp) -> Outcome {
+    while (true) {
+      if (!meter.tick()) {
+        return Outcome::Timeout;
+      }
+      const auto &instruction = program.code[pc];
+      if (sp == text.size() && readsText(instruction.op)) {
+        atEnd = true;
+      }
+      bool ok = true;
+      switch (instruction.op) {
+      case OpCode::Byte:
+        ok = sp < text.size() &&
+             static_cast<unsigned char>(text[sp]) == instruction.byte;
+        ++sp;
+        break;
+      case OpCode::Set:
+        ok = sp < text.size() &&
+             program.sets[instruction.x].test(
+                 static_cast<unsigned char>(text[sp]));
+        ++sp;
+        break;
+      case OpCode::Split:
+        stack.push_back({Frame::Branch, instruction.y, sp});
+        pc = instruction.x;
+        continue;
+      case OpCode::Jump:
+        pc = instruction.x;
+        continue;
+      case OpCode::Save:
+        stack.push_back({Frame::Slot, instruction.x, slots[instruction.x]});
+        slots[instruction.x] = sp;
+        break;
+      case OpCode::Mark:
+        stack.push_back({Frame::Mark, instruction.x, marks[instruction.x]});
+        marks[instruction.x] = sp;
+        break;
+      case OpCode::Progress:
+        ok = marks[instruction.x] != sp;
+        break;
+      case OpCode::LineBegin:
+        ok = sp == 0;
+        break;
+      case OpCode::LineEnd:
+        ok = sp == text.size();
+        break;
+      case OpCode::WordBoundary:
+        ok = atWordBoundary(sp);
+        break;
+      case OpCode::NotWordBoundary:
+        ok = !atWordBoundary(sp);
+        break;
+      case OpCode::Backreference: {
+        // A group that did not take part fails, as in std::regex
+        auto start = slots[2 * instruction.x];
+        auto end = slots[2 * instruction.x + 1];
+        ok = start != unset && end != unset && end >= start;
+        if (ok) {
+          auto group = text.substr(start, end - start);
+          atEnd = atEnd || text.size() - sp < group.size();
+          ok = text.substr(sp).starts_with(group);
+          sp += group.size();
+        }
+        break;
+      }
+      case OpCode::Lookahead:
+      case OpCode::NegativeLookahead: {
+        auto inner = stack.size();
+        auto outcome = run(pc + 1, sp);
+        if (outcome == Outcome::Timeout) {
+          return outcome;
+        }
+        bool matched = outcome == Outcome::Matched;
+        if (instruction.op == OpCode::Lookahead && matched) {
+          // Atomic: its other branches are dropped, its captures kept
+          auto kept = std::remove_if(
+              stack.begin() + static_cast<std::ptrdiff_t>(inner), stack.end(),
+              [](const Frame &f) { return f.kind == Frame::Branch; });
+          stack.erase(kept, stack.end());
+        } else if (matched) {
+          unwind(inner);
+        }
+        if (matched != (instruction.op == OpCode::Lookahead)) {
+          return Outcome::Failed;
+        }
+        pc = instruction.x;
+        continue;
+      }
+      case OpCode::Match:
+        return Outcome::Matched;
+      }
+      if (!ok) {
+        return Outcome::Failed;
+      }
+      ++pc;
+    }
+  }
+
+  // Instructions whose outcome at the end of the text depends on what
+  // would follow (Match does not: the match simply ends there)
+  static auto readsText(OpCode op) -> bool {
+    return op == OpCode::Byte || op == OpCode::Set || op == OpCode::LineEnd ||
+           op == OpCode::WordBoundary || op == OpCode::NotWordBoundary ||
+           op == OpCode::Backreference;
+  }
+
+  // Function restores the captures recorded above 'base'
+  void unwind(size_t base) {
+    while (stack.size() > base) {
+      auto frame = stack.back();
+      stack.pop_back();
+      if (frame.kind == Frame::Slot) {
+        slots[frame.a] = frame.b;
+      } else if (frame.kind == Frame::Mark) {
+        marks[frame.a] = frame.b;
+      }
+    }
+  }
+
+  const Program &program;
+  std::string_view text;
+  StepMeter meter;
+  std::vector<size_t> slots;
+  std::vector<size_t> marks;
+  std::vector<Frame> stack;
+  bool atEnd = false;
+};
+
+} // namespace
+
+auto Regex::compile(std::string_view pattern)
+    -> std::expected<Regex, std::string> {
+  auto ast = parsePattern(pattern);
+  if (!ast) {
+    return std::unexpected(std::format("{} at position {}", ast.error().message,
+                                       ast.error().position));
+  }
+  auto program = compileProgram(*ast);
+  if (!program) {
+    return std::unexpected(program.error());
+  }
+  Regex regex;
+  regex.source = pattern;
+  regex.program = std::move(*program);
+  return regex;
+}
+
+auto Regex::search(std::string_view text, const Budget &budget,
+                   size_t from) const -> SearchResult {
+  // No match starts before the next place the prefilter finds
+  if (!program.anchored) {
+    from = program.prefilter.next(text, from);
+    if (from == std::string_view::npos) {
+      return {};
+    }
+  }
+  if (program.backtracking) {
+    return backtrack(text, budget, from);
+  }
+
+  // Most texts do not match: the DFA says so in one pass, and the Pike VM
+  // only runs to find where the match is
+  SearchResult scan;
+  if (dfaSupports(program)) {
+    scan = dfaScan(program, text, budget, from);
+    if (scan.status != SearchStatus::Found) {
+      return scan;
+    }
+  }
+  Budget rest = budget;
+  rest.max_steps -= std::min(rest.max_steps, scan.steps);
+  auto result = pikeSearch(program, text, rest, from);
+  result.steps += scan.steps;
+  return result;
+}
+
+auto Regex::backtrack(std::string_view text, const Budget &budget,
+                      size_t from) const -> SearchResult {
+  Backtracker matcher(program, text, budget);
+  size_t last = program.anchored ? 0 : text.size();
+  for (auto start = from; start <= last;
+       start = program.prefilter.next(text, start + 1)) {
+    switch (matcher.run(0, start)) {
+    case Backtracker::Outcome::Matched:
+      return {SearchStatus::Found, matcher.slot(0),
+              matcher.slot(1) - matcher.slot(0), matcher.steps(),
+              matcher.hitEnd()};
+    case Backtracker::Outcome::Timeout:
+      return {SearchStatus::Timeout, 0, 0, matcher.steps()};
+    case Backtracker::Outcome::Failed:
+      break;
+    }
+  }
+  return {SearchStatus::NotFound, 0, 0, matcher.steps(), matcher.hitEnd()};
+}
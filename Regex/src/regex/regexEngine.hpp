@@ -0,0 +1,106 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Matching engine with a budget: the matchers count their steps and check
+ * the deadline while they run, and stop cleanly when either is exhausted. No
+ * thread is started and nothing is shared between searches, so a runaway
+ * pattern only costs its own budget.
+ *
+ * Patterns are run by automata that never backtrack (regexAutomaton.hpp),
+ * in time linear in the text. Only the patterns that need it, with
+ * backreferences or lookahead, use the backtracking matcher.
+ */
+#pragma once
+
+#include "regexProgram.hpp"
+
+#include <chrono>
+#include <expected>
+#include <limits>
+#include <string>
+#include <string_view>
+
+// Limits of one search
+struct Budget {
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::time_point::max();
+  size_t max_steps = std::numeric_limits<size_t>::max();
+
+  // Function returns a budget ending 'timeout' from now
+  static auto after(std::chrono::nanoseconds timeout) -> Budget {
+    return {std::chrono::steady_clock::now() + timeout};
+  }
+};
+
+// Steps spent by a matcher, checked against its budget (the clock is read
+// once every 1024 steps)
+class StepMeter {
+public:
+  explicit StepMeter(const Budget &budget) : budget(budget) {}
+
+  // Function counts steps (false once the budget is exhausted)
+  auto tick(size_t steps = 1) -> bool {
+    auto before = count;
+    count += steps;
+    if (count > budget.max_steps) {
+      return false;
+    }
+    return before / clock_interval == count / clock_interval ||
+           std::chrono::steady_clock::now() < budget.deadline;
+  }
+
+  auto steps() const -> size_t { return count; }
+
+private:
+  static constexpr size_t clock_interval = 1024;
+
+  const Budget &budget;
+  size_t count = 0;
+};
+
+enum class SearchStatus { Found, NotFound, Timeout };
+
+// Matcher a pattern runs on
+enum class Backend { Automaton, Backtracking };
+
+struct SearchResult {
+  SearchStatus status = SearchStatus::NotFound;
+  size_t position = 0; // Of the match in the text
+  size_t length = 0;
+  size_t steps = 0; // Spent by the matcher
+  // The result depends on the end of the text: a byte was wanted or an
+  // assertion ($, \b, lookahead) was decided there, so more text could
+  // change it
+  bool hit_end = false;
+};
+
+class Regex {
+public:
+  // Function compiles a pattern (error message otherwise)
+  static auto compile(std::string_view pattern)
+      -> std::expected<Regex, std::string>;
+
+  // Function finds the leftmost match at or after 'from', with the same
+  // preference as std::regex_search (ECMAScript)
+  auto search(std::string_view text, const Budget &budget = {},
+              size_t from = 0) const -> SearchResult;
+
+  auto pattern() const -> const std::string & { return source; }
+
+  auto groups() const -> size_t { return program.slots / 2 - 1; }
+
+  auto backend() const -> Backend {
+    return program.backtracking ? Backend::Backtracking : Backend::Automaton;
+  }
+
+private:
+  friend class RegexSet; // Joins the programs of its patterns
+
+  Regex() = default;
+
+  auto backtrack(std::string_view text, const Budget &budget,
+                 size_t from) const -> SearchResult;
+
+  std::string source;
+  Program program;
+};
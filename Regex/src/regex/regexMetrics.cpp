@@ -0,0 +1,174 @@
+#include "regexMetrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+
+namespace {
+
+// Function returns the bucket of a latency: exact under 4 ns, then the
+// power of two and the quarter of it the latency falls in
+auto bucketOf(uint64_t ns) -> size_t {
+  if (ns < 4) {
+    return ns;
+  }
+  auto exponent = static_cast<size_t>(std::bit_width(ns)) - 1;
+  auto quarter = (ns >> (exponent - 2)) & 3;
+  return 4 * (exponent - 1) + quarter;
+}
+
+// Function returns the largest latency of a bucket
+auto upperBound(size_t bucket) -> uint64_t {
+  if (bucket < 4) {
+    return bucket;
+  }
+  auto shift = bucket / 4 - 1;
+  uint64_t lower = (4 + bucket % 4) << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+// Function appends a text as a JSON string
+void appendJson(std::string &out, std::string_view text) {
+  out += '"';
+  for (auto c : text) {
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        out += std::format("\\u{:04x}", static_cast<unsigned char>(c));
+      } else {
+        out += c;
+      }
+      break;
+    }
+  }
+  out += '"';
+}
+
+} // namespace
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+  latency = std::max(latency, std::chrono::nanoseconds::zero());
+  ++counts[bucketOf(static_cast<uint64_t>(latency.count()))];
+  ++total;
+  elapsed += latency;
+  maximum = std::max(maximum, latency);
+}
+
+auto LatencyHistogram::percentile(double fraction) const
+    -> std::chrono::nanoseconds {
+  if (total == 0) {
+    return {};
+  }
+  // Rank of the search, 1 for the fastest
+  auto rank = static_cast<size_t>(
+      std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total)));
+  rank = std::max<size_t>(rank, 1);
+  size_t seen = 0;
+  for (size_t bucket = 0; bucket < buckets; ++bucket) {
+    seen += counts[bucket];
+    if (seen >= rank) {
+      auto bound = std::chrono::nanoseconds(
+          static_cast<std::chrono::nanoseconds::rep>(upperBound(bucket)));
+      return std::min(bound, maximum);
+    }
+  }
+  return maximum;
+}
+
+MetricsRegistry::MetricsRegistry(size_t capacity)
+    : capacity(std::max<size_t>(capacity, 1)) {}
+
+void MetricsRegistry::record(std::string_view pattern, SearchStatus status,
+                             size_t bytes, std::chrono::nanoseconds latency) {
+  std::lock_guard lock(mutex);
+  auto it = patterns.find(pattern);
+  if (it == patterns.end()) {
+    if (patterns.size() >= capacity) {
+      pattern = other_patterns;
+    }
+    it = patterns.try_emplace(std::string(pattern)).first;
+  }
+  auto &counters = it->second;
+  ++counters.searches;
+  counters.matches += status == SearchStatus::Found;
+  counters.timeouts += status == SearchStatus::Timeout;
+  counters.bytes += bytes;
+  counters.latency.record(latency);
+}
+
+auto MetricsRegistry::get(std::string_view pattern) const
+    -> std::optional<PatternMetrics> {
+  std::lock_guard lock(mutex);
+  auto it = patterns.find(pattern);
+  if (it == patterns.end()) {
+    return std::nullopt;
+  }
+  return metrics(it->first, it->second);
+}
+
+auto MetricsRegistry::all() const -> std::vector<PatternMetrics> {
+  std::vector<PatternMetrics> result;
+  {
+    std::lock_guard lock(mutex);
+    result.reserve(patterns.size());
+    for (const auto &[pattern, counters] : patterns) {
+      result.push_back(metrics(pattern, counters));
+    }
+  }
+  std::ranges::sort(result, std::ranges::greater{}, &PatternMetrics::total);
+  return result;
+}
+
+auto MetricsRegistry::toJson() const -> std::string {
+  std::string out = "{\"patterns\": [";
+  auto separator = "\n  ";
+  for (const auto &metrics : all()) {
+    out += separator;
+    separator = ",\n  ";
+    out += "{\"pattern\": ";
+    appendJson(out, metrics.pattern);
+    out += std::format(", \"searches\": {}, \"matches\": {}, \"timeouts\": {}"
+                       ", \"bytes_scanned\": {}",
+                       metrics.searches, metrics.matches, metrics.timeouts,
+                       metrics.bytes);
+    out += std::format(", \"latency_ns\": {{\"total\": {}, \"p50\": {}, "
+                       "\"p99\": {}, \"max\": {}}}}}",
+                       metrics.total.count(), metrics.p50.count(),
+                       metrics.p99.count(), metrics.max.count());
+  }
+  out += "\n]}";
+  return out;
+}
+
+void MetricsRegistry::clear() {
+  std::lock_guard lock(mutex);
+  patterns.clear();
+}
+
+auto MetricsRegistry::metrics(std::string_view pattern,
+                              const Counters &counters) -> PatternMetrics {
+  PatternMetrics result;
+  result.pattern = pattern;
+  result.searches = counters.searches;
+  result.matches = counters.matches;
+  result.timeouts = counters.timeouts;
+  result.bytes = counters.bytes;
+  result.total = counters.latency.sum();
+  result.p50 = counters.latency.percentile(0.5);
+  result.p99 = counters.latency.percentile(0.99);
+  result.max = counters.latency.max();
+  return result;
+}
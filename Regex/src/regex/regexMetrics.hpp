@@ -0,0 +1,105 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Counters of the searches made with each pattern: how many, how many
+ * matched or timed out, the bytes they read and a histogram of their
+ * latency (p50, p99, max). The registry is shared by every thread and can be
+ * queried, or dumped as JSON, to find the patterns using the time budget.
+ */
+#pragma once
+
+#include "regexEngine.hpp"
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// Latencies counted in buckets four per power of two: a percentile is off by
+// at most a quarter (exact under 4 ns), the max is exact
+class LatencyHistogram {
+public:
+  void record(std::chrono::nanoseconds latency);
+
+  // Function returns the latency under which 'fraction' of the searches ran
+  // (upper bound of its bucket, zero when nothing was recorded)
+  auto percentile(double fraction) const -> std::chrono::nanoseconds;
+
+  auto count() const -> size_t { return total; }
+  auto sum() const -> std::chrono::nanoseconds { return elapsed; }
+  auto max() const -> std::chrono::nanoseconds { return maximum; }
+
+private:
+  static constexpr size_t buckets = 4 * 64;
+
+  std::array<size_t, buckets> counts{};
+  size_t total = 0;
+  std::chrono::nanoseconds elapsed{};
+  std::chrono::nanoseconds maximum{};
+};
+
+// What a pattern did, as read from the registry
+struct PatternMetrics {
+  std::string pattern;
+  size_t searches = 0;
+  size_t matches = 0;
+  size_t timeouts = 0;
+  size_t bytes = 0;                  // Size of the texts searched
+  std::chrono::nanoseconds total{};  // Time of all the searches
+  std::chrono::nanoseconds p50{};
+  std::chrono::nanoseconds p99{};
+  std::chrono::nanoseconds max{};
+};
+
+class MetricsRegistry {
+public:
+  // Past 'capacity' patterns, new ones are counted together under
+  // other_patterns (at least one pattern is kept)
+  explicit MetricsRegistry(size_t capacity = 1024);
+
+  MetricsRegistry(const MetricsRegistry &) = delete;
+  auto operator=(const MetricsRegistry &) -> MetricsRegistry & = delete;
+
+  static constexpr std::string_view other_patterns = "(other patterns)";
+
+  // Function counts a search of a text of 'bytes' with a pattern
+  void record(std::string_view pattern, SearchStatus status, size_t bytes,
+              std::chrono::nanoseconds latency);
+
+  // Function returns the counters of a pattern (none if never searched)
+  auto get(std::string_view pattern) const -> std::optional<PatternMetrics>;
+
+  // Function returns the counters of every pattern, the most time first
+  auto all() const -> std::vector<PatternMetrics>;
+
+  // Function returns all() as a JSON object, latencies in nanoseconds
+  auto toJson() const -> std::string;
+
+  void clear();
+
+private:
+  struct Counters {
+    size_t searches = 0;
+    size_t matches = 0;
+    size_t timeouts = 0;
+    size_t bytes = 0;
+    LatencyHistogram latency;
+  };
+
+  // Lookup by string_view, without copying the pattern
+  struct Hash {
+    using is_transparent = void;
+    auto operator()(std::string_view text) const -> size_t {
+      return std::hash<std::string_view>{}(text);
+    }
+  };
+
+  static auto metrics(std::string_view pattern, const Counters &counters)
+      -> PatternMetrics;
+
+  size_t capacity;
+  mutable std::mutex mutex;
+  std::unordered_map<std::string, Counters, Hash, std::equal_to<>> patterns;
+};
@@ -0,0 +1,467 @@
+#include "regexParser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+namespace {
+
+// Deeper nesting is rejected instead of exhausting the stack
+constexpr size_t max_depth = 256;
+
+// Largest count accepted in {n,m}
+constexpr size_t max_count = 1000;
+
+auto byteSet(std::string_view bytes) -> ByteSet {
+  ByteSet set;
+  for (unsigned char c : bytes) {
+    set.set(c);
+  }
+  return set;
+}
+
+auto rangeSet(unsigned char first, unsigned char last) -> ByteSet {
+  ByteSet set;
+  for (unsigned c = first; c <= last; ++c) {
+    set.set(c);
+  }
+  return set;
+}
+
+auto digitSet() -> ByteSet { return rangeSet('0', '9'); }
+
+auto wordSet() -> ByteSet {
+  return rangeSet('a', 'z') | rangeSet('A', 'Z') | digitSet() | byteSet("_");
+}
+
+auto spaceSet() -> ByteSet { return byteSet(" \t\n\r\f\v"); }
+
+// '.' stops at line terminators
+auto dotSet() -> ByteSet { return ~byteSet("\n\r"); }
+
+auto hexValue(char c) -> int {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+class Parser {
+public:
+  explicit Parser(std::string_view pattern) : pattern(pattern) {}
+
+  auto parse() -> std::expected<Ast, ParseError> {
+    try {
+      Ast ast;
+      ast.root = alternation(0);
+      if (pos < pattern.size()) {
+        fail("unmatched ')'");
+      }
+      ast.groups = groups;
+      return ast;
+    } catch (const ParseError &error) {
+      return std::unexpected(error);
+    }
+  }
+
+private:
+  [[noreturn]] void fail(std::string message) const {
+    throw ParseError{pos, std::move(message)};
+  }
+
+  auto atEnd() const -> bool { return pos >= pattern.size(); }
+
+  auto peek() const -> char { return atEnd() ? '\0' : pattern[pos]; }
+
+  auto accept(char c) -> bool {
+    if (!atEnd() && pattern[pos] == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+
+  auto alternation(size_t depth) -> Node {
+    if (depth > max_depth) {
+      fail("pattern nested too deeply");
+    }
+    auto first = sequence(depth);
+    if (peek() != '|') {
+      return first;
+    }
+    auto node = make(NodeType::Alternation);
+    node.children.push_back(std::move(first));
+    while (accept('|')) {
+      node.children.push_back(sequence(depth));
+    }
+    return node;
+  }
+
+  auto sequence(size_t depth) -> Node {
+    auto node = make(NodeType::Concat);
+    while (!atEnd() && peek() != '|' && peek() != ')') {
+      node.children.push_back(quantified(depth));
+    }
+    if (node.children.size() == 1) {
+      return std::move(node.children.front());
+    }
+    if (node.children.empty()) {
+      return Node{};
+    }
+    return node;
+  }
+
+  auto quantified(size_t depth) -> Node {
+    auto start = pos;
+    auto atom = this->atom(depth);
+    size_t min = 0;
+    size_t max = 0;
+    switch (peek()) {
+    case '*':
+      ++pos;
+      max = unbounded;
+      break;
+    case '+':
+      ++pos;
+      min = 1;
+      max = unbounded;
+      break;
+    case '?':
+      ++pos;
+      max = 1;
+      break;
+    case '{':
+      ++pos;
+      if (!counts(min, max)) {
+        fail("invalid {n,m} quantifier");
+      }
+      break;
+    default:
+      return atom;
+    }
+    if (!repeatable(atom.type)) {
+      pos = start;
+      fail("nothing to repeat");
+    }
+    auto node = make(NodeType::Repeat);
+    node.min = min;
+    node.max = max;
+    node.greedy = !accept('?');
+    node.children.push_back(std::move(atom));
+    return node;
+  }
+
+  static auto repeatable(NodeType type) -> bool {
+    return type != NodeType::LineBegin && type != NodeType::LineEnd &&
+           type != NodeType::WordBoundary && type != NodeType::Lookahead;
+  }
+
+  // Reads "n}", "n,}" or "n,m}" after '{'
+  auto counts(size_t &min, size_t &max) -> bool {
+    if (!number(min)) {
+      return false;
+    }
+    max = min;
+    if (accept(',')) {
+      max = unbounded;
+      if (peek() != '}' && !number(max)) {
+        return false;
+      }
+    }
+    if (!accept('}')) {
+      return false;
+    }
+    if (max < min) {
+      fail("{n,m} with m < n");
+    }
+    if (min > max_count || (max != unbounded && max > max_count)) {
+      fail("repetition count too large");
+    }
+    return true;
+  }
+
+  auto number(size_t &value) -> bool {
+    auto rest = pattern.substr(pos);
+    auto [ptr, ec] = std::from_chars(rest.data(), rest.data() + rest.size(),
+                                     value);
+    if (ptr == rest.data()) {
+      return false;
+    }
+    if (ec != std::errc{}) {
+      fail("repetition count too large");
+    }
+    pos += static_cast<size_t>(ptr - rest.data());
+    return true;
+  }
+
+  auto atom(size_t depth) -> Node {
+    auto c = pattern[pos++];
+    switch (c) {
+    case '.':
+      return setNode(dotSet());
+    case '^':
+      return make(NodeType::LineBegin);
+    case '$':
+      return make(NodeType::LineEnd);
+    case '(':
+      return group(depth);
+    case '[':
+      return bracket();
+    case '\\':
+      return escape();
+    case '*':
+    case '+':
+    case '?':
+      --pos;
+      fail("nothing to repeat");
+    case '{':
+      --pos;
+      fail("invalid {n,m} quantifier");
+    default:
+      return literal(static_cast<unsigned char>(c));
+    }
+  }
+
+  static auto make(NodeType type) -> Node {
+    Node node;
+    node.type = type;
+    return node;
+  }
+
+  static auto literal(unsigned char c) -> Node {
+    auto node = make(NodeType::Byte);
+    node.byte = c;
+    return node;
+  }
+
+  static auto setNode(const ByteSet &set) -> Node {
+    auto node = make(NodeType::Set);
+    node.set = set;
+    return node;
+  }
+
+  auto group(size_t depth) -> Node {
+    auto node = make(NodeType::Group);
+    if (accept('?')) {
+      if (peek() == '=' || peek() == '!') {
+        node.type = NodeType::Lookahead;
+        node.negated = pattern[pos++] == '!';
+      } else if (!accept(':')) {
+        fail("unsupported group syntax");
+      }
+    } else {
+      node.index = ++groups;
+      open.push_back(node.index);
+    }
+    node.children.push_back(alternation(depth + 1));
+    if (!accept(')')) {
+      fail("missing ')'");
+    }
+    if (node.index > 0) {
+      open.pop_back();
+    }
+    return node;
+  }
+
+  auto escape() -> Node {
+    if (atEnd()) {
+      fail("pattern ends with '\\'");
+    }
+    auto c = pattern[pos];
+    if (c >= '1' && c <= '9') {
+      // As std::regex: only to a group already closed, \1(a) and (a\1)
+      // are rejected
+      size_t index = 0;
+      number(index);
+      if (index > groups) {
+        fail("backreference to a missing group");
+      }
+      if (std::ranges::find(open, index) != open.end()) {
+        fail("backreference to an open group");
+      }
+      auto node = make(NodeType::Backreference);
+      node.index = index;
+      return node;
+    }
+    if (c == 'b' || c == 'B') {
+      ++pos;
+      auto node = make(NodeType::WordBoundary);
+      node.negated = c == 'B';
+      return node;
+    }
+    ByteSet set;
+    if (classEscape(set)) {
+      return setNode(set);
+    }
+    return literal(escapedByte());
+  }
+
+  // Reads \d \D \w \W \s \S (false for other escapes, nothing read)
+  auto classEscape(ByteSet &set) -> bool {
+    switch (pattern[pos]) {
+    case 'd':
+      set = digitSet();
+      break;
+    case 'D':
+      set = ~digitSet();
+      break;
+    case 'w':
+      set = wordSet();
+      break;
+    case 'W':
+      set = ~wordSet();
+      break;
+    case 's':
+      set = spaceSet();
+      break;
+    case 'S':
+      set = ~spaceSet();
+      break;
+    default:
+      return false;
+    }
+    ++pos;
+    return true;
+  }
+
+  // Reads the byte of an escape such as \n, \x41 or \.
+  auto escapedByte() -> unsigned char {
+    auto c = pattern[pos++];
+    switch (c) {
+    case 'n':
+      return '\n';
+    case 'r':
+      return '\r';
+    case 't':
+      return '\t';
+    case 'f':
+      return '\f';
+    case 'v':
+      return '\v';
+    case '0':
+      return '\0';
+    case 'c':
+      if (!atEnd() && std::isalpha(static_cast<unsigned char>(peek()))) {
+        return static_cast<unsigned char>(pattern[pos++] % 32);
+      }
+      fail("invalid control escape");
+    case 'x':
+    case 'u': {
+      size_t digits = c == 'x' ? 2 : 4;
+      unsigned value = 0;
+      for (size_t i = 0; i < digits; ++i) {
+        auto digit = atEnd() ? -1 : hexValue(pattern[pos]);
+        if (digit < 0) {
+          fail("invalid hexadecimal escape");
+        }
+        value = value * 16 + static_cast<unsigned>(digit);
+        ++pos;
+      }
+      if (value > 0xFF) {
+        fail("code point above 0xFF");
+      }
+      return static_cast<unsigned char>(value);
+    }
+    default:
+      return static_cast<unsigned char>(c);
+    }
+  }
+
+  auto bracket() -> Node {
+    auto node = make(NodeType::Set);
+    bool negated = accept('^');
+    while (!accept(']')) { // [] matches nothing, [^] any byte
+      if (atEnd()) {
+        fail("missing ']'");
+      }
+      ByteSet set;
+      unsigned char low = 0;
+      if (!classAtom(set, low)) {
+        node.set |= set; // \d and the like end a range
+        continue;
+      }
+      if (peek() == '-' && pos + 1 < pattern.size() &&
+          pattern[pos + 1] != ']') {
+        ++pos;
+        unsigned char high = 0;
+        if (!classAtom(set, high)) {
+          fail("invalid range in class");
+        }
+        if (high < low) {
+          fail("range out of order in class");
+        }
+        node.set |= rangeSet(low, high);
+      } else {
+        node.set.set(low);
+      }
+    }
+    if (negated) {
+      node.set.flip();
+    }
+    return node;
+  }
+
+  // Reads one byte of a class (false when it is a set such as \d)
+  auto classAtom(ByteSet &set, unsigned char &byte) -> bool {
+    auto c = pattern[pos++];
+    if (c != '\\') {
+      byte = static_cast<unsigned char>(c);
+      return true;
+    }
+    if (atEnd()) {
+      fail("pattern ends with '\\'");
+    }
+    if (classEscape(set)) {
+      return false;
+    }
+    if (accept('b')) {
+      byte = '\b';
+      return true;
+    }
+    byte = escapedByte();
+    return true;
+  }
+
+  std::string_view pattern;
+  size_t pos = 0;
+  size_t groups = 0;
+  std::vector<size_t> open; // Capturing groups around the current position
+};
+
+} // namespace
+
+auto parsePattern(std::string_view pattern) -> std::expected<Ast, ParseError> {
+  return Parser(pattern).parse();
+}
+
+auto needsBacktracking(const Node &node) -> bool {
+  if (node.type == NodeType::Backreference ||
+      node.type == NodeType::Lookahead) {
+    return true;
+  }
+  return std::ranges::any_of(node.children, needsBacktracking);
+}
+
+auto matchesEmpty(const Node &node) -> bool {
+  switch (node.type) {
+  case NodeType::Byte:
+  case NodeType::Set:
+    return false;
+  case NodeType::Group:
+    return matchesEmpty(node.children.front());
+  case NodeType::Concat:
+    return std::ranges::all_of(node.children, matchesEmpty);
+  case NodeType::Alternation:
+    return std::ranges::any_of(node.children, matchesEmpty);
+  case NodeType::Repeat:
+    return node.min == 0 || matchesEmpty(node.children.front());
+  default:
+    return true; // Assertions, backreferences
+  }
+}
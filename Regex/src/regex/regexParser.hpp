@@ -0,0 +1,66 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Parser of the ECMAScript syntax used by std::regex, producing a tree the
+ * matchers are compiled from. Patterns are read byte by byte.
+ */
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Bytes matched by a class such as [a-z], '.' or \d
+using ByteSet = std::bitset<256>;
+
+// Upper bound of a repetition without one (*, +, {n,})
+constexpr size_t unbounded = static_cast<size_t>(-1);
+
+enum class NodeType {
+  Empty,         // Matches the empty string
+  Byte,          // Literal byte
+  Set,           // Class, '.', \d, ...
+  LineBegin,     // ^
+  LineEnd,       // $
+  WordBoundary,  // \b, or \B when negated
+  Group,         // (...) capturing when index > 0, (?:...) otherwise
+  Concat,        // Children one after the other
+  Alternation,   // One of the children, the first ones preferred
+  Repeat,        // Child repeated [min, max] times
+  Backreference, // \1, \2, ...
+  Lookahead,     // (?=...), or (?!...) when negated
+};
+
+struct Node {
+  NodeType type = NodeType::Empty;
+  unsigned char byte = 0;
+  ByteSet set;
+  size_t index = 0; // Group or backreference number
+  size_t min = 0;
+  size_t max = 0;
+  bool greedy = true;
+  bool negated = false;
+  std::vector<Node> children;
+};
+
+struct Ast {
+  Node root;
+  size_t groups = 0; // Capturing groups, the whole match not included
+};
+
+struct ParseError {
+  size_t position = 0;
+  std::string message;
+};
+
+// Function parses a pattern (error with the offending position otherwise)
+auto parsePattern(std::string_view pattern) -> std::expected<Ast, ParseError>;
+
+// Function checks if a tree needs backtracking (backreferences, lookahead)
+auto needsBacktracking(const Node &node) -> bool;
+
+// Function checks if a tree can match the empty string
+auto matchesEmpty(const Node &node) -> bool;
@@ -0,0 +1,88 @@
+#include "regexPool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+ThreadPool::ThreadPool(size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    workers.emplace_back([this](std::stop_token stop) { run(stop); });
+  }
+}
+
+void ThreadPool::submit(Task task) {
+  {
+    std::lock_guard lock(mutex);
+    tasks.push_back(std::move(task));
+  }
+  wake.notify_one();
+}
+
+void ThreadPool::parallel_for(size_t count,
+                              const std::function<void(size_t)> &task) {
+  std::mutex doneMutex;
+  std::condition_variable done;
+  size_t remaining = count;
+  std::exception_ptr failure; // First exception thrown by a task
+
+  for (size_t i = 0; i < count; ++i) {
+    submit([&, i] {
+      std::exception_ptr error;
+      try {
+        task(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard lock(doneMutex);
+      if (error && !failure) {
+        failure = error;
+      }
+      if (--remaining == 0) {
+        done.notify_all();
+      }
+    });
+  }
+
+  // Help with the queued tasks instead of only waiting
+  std::unique_lock lock(doneMutex);
+  while (remaining > 0) {
+    lock.unlock();
+    if (auto job = take()) {
+      job();
+      lock.lock();
+      continue;
+    }
+    lock.lock();
+    done.wait(lock, [&remaining] { return remaining == 0; });
+  }
+
+  // Only now, when no task references this frame anymore
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
+void ThreadPool::run(std::stop_token stop) {
+  while (true) {
+    std::unique_lock lock(mutex);
+    if (!wake.wait(lock, stop, [this] { return !tasks.empty(); })) {
+      return; // Stopped
+    }
+    auto task = std::move(tasks.front());
+    tasks.pop_front();
+    lock.unlock();
+    task();
+  }
+}
+
+auto ThreadPool::take() -> Task {
+  std::lock_guard lock(mutex);
+  if (tasks.empty()) {
+    return {};
+  }
+  auto task = std::move(tasks.front());
+  tasks.pop_front();
+  return task;
+}
@@ -0,0 +1,46 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Fixed set of worker threads, started once and shared by every search, so
+ * concurrent searches run side by side without a thread created per call.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  // threads = 0: one per core
+  explicit ThreadPool(size_t threads = 0);
+
+  ThreadPool(const ThreadPool &) = delete;
+  auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+  // Queues a task, run by the first worker free
+  void submit(Task task);
+
+  // Runs task(i) for every i in [0, count) and waits for all of them.
+  // The calling thread helps, so it can also be used inside a task.
+  // If tasks throw, the first exception is rethrown after all finished.
+  void parallel_for(size_t count, const std::function<void(size_t)> &task);
+
+  auto size() const -> size_t { return workers.size(); }
+
+private:
+  void run(std::stop_token stop);
+
+  // Oldest task first (empty when there is none)
+  auto take() -> Task;
+
+  std::mutex mutex;
+  std::condition_variable_any wake;
+  std::deque<Task> tasks;
+  std::vector<std::jthread> workers; // Last, stopped before the queue goes
+};
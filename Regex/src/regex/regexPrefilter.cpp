@@ -0,0 +1,133 @@
+#include "regexPrefilter.hpp"
+
+#include <cstring>
+
+namespace {
+
+// Longer prefixes do not make the search skip more
+constexpr size_t max_prefix = 64;
+
+// A set passing more bytes than this skips too little
+constexpr size_t max_first_bytes = 128;
+
+// Function adds the bytes a non-empty match of 'node' can start with to
+// 'first' (true when it can match empty, so what follows can start it too)
+auto addFirst(const Node &node, ByteSet &first) -> bool {
+  switch (node.type) {
+  case NodeType::Byte:
+    first.set(node.byte);
+    return false;
+  case NodeType::Set:
+    first |= node.set;
+    return false;
+  case NodeType::Group:
+    return addFirst(node.children.front(), first);
+  case NodeType::Concat:
+    for (const auto &child : node.children) {
+      if (!addFirst(child, first)) {
+        return false;
+      }
+    }
+    return true;
+  case NodeType::Alternation: {
+    bool empty = false;
+    for (const auto &child : node.children) {
+      empty = addFirst(child, first) || empty;
+    }
+    return empty;
+  }
+  case NodeType::Repeat:
+    if (node.max == 0) {
+      return true;
+    }
+    return addFirst(node.children.front(), first) || node.min == 0;
+  case NodeType::Backreference:
+    first.set(); // Any text
+    return true;
+  default:
+    return true; // Empty, assertions: nothing read
+  }
+}
+
+// Function appends the bytes every match of 'node' starts with (true when
+// they are the whole match, so what follows adds to them)
+auto appendPrefix(const Node &node, std::string &prefix) -> bool {
+  if (prefix.size() >= max_prefix) {
+    return false;
+  }
+  switch (node.type) {
+  case NodeType::Byte:
+    prefix += static_cast<char>(node.byte);
+    return true;
+  case NodeType::Set:
+    if (node.set.count() != 1) {
+      return false;
+    }
+    for (size_t c = 0; c < node.set.size(); ++c) {
+      if (node.set[c]) {
+        prefix += static_cast<char>(c);
+      }
+    }
+    return true;
+  case NodeType::Group:
+    return appendPrefix(node.children.front(), prefix);
+  case NodeType::Concat:
+    for (const auto &child : node.children) {
+      if (!appendPrefix(child, prefix)) {
+        return false;
+      }
+    }
+    return true;
+  case NodeType::Repeat:
+    for (size_t i = 0; i < node.min; ++i) {
+      if (!appendPrefix(node.children.front(), prefix)) {
+        return false;
+      }
+    }
+    return node.min == node.max;
+  case NodeType::Alternation:
+  case NodeType::Backreference:
+    return false;
+  default:
+    return true; // Empty, assertions: nothing read
+  }
+}
+
+} // namespace
+
+auto Prefilter::next(std::string_view text, size_t from) const -> size_t {
+  if (!active) {
+    return from;
+  }
+  if (from >= text.size()) {
+    return std::string_view::npos; // A match reads at least one byte
+  }
+  if (prefix.size() > 1) {
+    return text.find(prefix, from);
+  }
+  if (prefix.size() == 1) {
+    const auto *found =
+        std::memchr(text.data() + from, prefix[0], text.size() - from);
+    if (found == nullptr) {
+      return std::string_view::npos;
+    }
+    return static_cast<size_t>(static_cast<const char *>(found) - text.data());
+  }
+  for (auto sp = from; sp < text.size(); ++sp) {
+    if (first[static_cast<unsigned char>(text[sp])]) {
+      return sp;
+    }
+  }
+  return std::string_view::npos;
+}
+
+auto buildPrefilter(const Node &root) -> Prefilter {
+  Prefilter prefilter;
+  if (addFirst(root, prefilter.first)) {
+    return prefilter; // Can match empty, anywhere
+  }
+  appendPrefix(root, prefilter.prefix);
+  prefilter.active = !prefilter.prefix.empty() ||
+                     prefilter.first.count() <= max_first_bytes;
+  return prefilter;
+}
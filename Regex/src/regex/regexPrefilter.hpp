@@ -0,0 +1,26 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * What every match of a pattern starts with, read from its tree: a literal
+ * prefix ("phone" for phone\d*) or the set of bytes a match can start with
+ * (the digits for \d+). A search jumps to the next place where one occurs,
+ * found by memchr or a substring search (vectorized by the C library),
+ * instead of starting the matcher at every position of the text.
+ */
+#pragma once
+
+#include "regexParser.hpp"
+
+struct Prefilter {
+  std::string prefix;  // Bytes every match starts with
+  ByteSet first;       // Bytes a match can start with
+  bool active = false; // Else a match can start anywhere, or be empty
+
+  // Function returns the first position at or after 'from' where a match
+  // can start (npos when there is none)
+  auto next(std::string_view text, size_t from) const -> size_t;
+};
+
+// Function reads the prefilter of a tree (inactive when it would not skip
+// enough to pay for itself)
+auto buildPrefilter(const Node &root) -> Prefilter;
@@ -0,0 +1,223 @@
+#include "regexProgram.hpp"
+
+namespace {
+
+// Larger programs are rejected (unrolled counts multiply quickly)
+constexpr size_t max_instructions = 100'000;
+
+struct TooLarge {};
+
+class Compiler {
+public:
+  explicit Compiler(Program &program) : program(program) {}
+
+  void emit(const Node &node) {
+    switch (node.type) {
+    case NodeType::Empty:
+      break;
+    case NodeType::Byte:
+      add({OpCode::Byte, node.byte});
+      break;
+    case NodeType::Set:
+      program.sets.push_back(node.set);
+      add({OpCode::Set, 0, program.sets.size() - 1});
+      break;
+    case NodeType::LineBegin:
+      add({OpCode::LineBegin});
+      break;
+    case NodeType::LineEnd:
+      add({OpCode::LineEnd});
+      break;
+    case NodeType::WordBoundary:
+      add({node.negated ? OpCode::NotWordBoundary : OpCode::WordBoundary});
+      break;
+    case NodeType::Group:
+      if (node.index > 0) {
+        add({OpCode::Save, 0, 2 * node.index});
+      }
+      emit(node.children.front());
+      if (node.index > 0) {
+        add({OpCode::Save, 0, 2 * node.index + 1});
+      }
+      break;
+    case NodeType::Concat:
+      for (const auto &child : node.children) {
+        emit(child);
+      }
+      break;
+    case NodeType::Alternation:
+      alternation(node);
+      break;
+    case NodeType::Repeat:
+      repeat(node);
+      break;
+    case NodeType::Backreference:
+      add({OpCode::Backreference, 0, node.index});
+      break;
+    case NodeType::Lookahead: {
+      auto start = add({node.negated ? OpCode::NegativeLookahead
+                                     : OpCode::Lookahead});
+      emit(node.children.front());
+      add({OpCode::Match});
+      program.code[start].x = program.code.size();
+      break;
+    }
+    }
+  }
+
+private:
+  auto add(Instruction instruction) -> size_t {
+    if (program.code.size() >= max_instructions) {
+      throw TooLarge{};
+    }
+    program.code.push_back(instruction);
+    return program.code.size() - 1;
+  }
+
+  // Split preferring 'first', the other branch patched later
+  void prefer(size_t split, size_t first, size_t other, bool greedy) {
+    program.code[split].x = greedy ? first : other;
+    program.code[split].y = greedy ? other : first;
+  }
+
+  void alternation(const Node &node) {
+    std::vector<size_t> jumps;
+    for (size_t i = 0; i + 1 < node.children.size(); ++i) {
+      auto split = add({OpCode::Split});
+      emit(node.children[i]);
+      jumps.push_back(add({OpCode::Jump}));
+      prefer(split, split + 1, program.code.size(), true);
+    }
+    emit(node.children.back());
+    for (auto jump : jumps) {
+      program.code[jump].x = program.code.size();
+    }
+  }
+
+  // Iterations past the minimum fail when they match the empty string, as
+  // in ECMAScript: this also keeps (a*)* from looping forever
+  void repeat(const Node &node) {
+    const auto &body = node.children.front();
+    for (size_t i = 0; i < node.min; ++i) {
+      emit(body);
+    }
+    auto mark = matchesEmpty(body) ? program.marks++ : unbounded;
+    auto optional = [&] {
+      if (mark != unbounded) {
+        add({OpCode::Mark, 0, mark});
+      }
+      emit(body);
+      if (mark != unbounded) {
+        add({OpCode::Progress, 0, mark});
+      }
+    };
+
+    if (node.max == unbounded) {
+      auto split = add({OpCode::Split});
+      optional();
+      add({OpCode::Jump, 0, split});
+      prefer(split, split + 1, program.code.size(), node.greedy);
+      return;
+    }
+
+    // Optional copies, x{2,4}: xx(x(x)?)?
+    std::vector<size_t> splits;
+    for (size_t i = node.min; i < node.max; ++i) {
+      splits.push_back(add({OpCode::Split}));
+      optional();
+    }
+    for (auto split : splits) {
+      prefer(split, split + 1, program.code.size(), node.greedy);
+    }
+  }
+
+  Program &program;
+};
+
+} // namespace
+
+auto compileProgram(const Ast &ast) -> std::expected<Program, std::string> {
+  Program program;
+  program.slots = 2 * (ast.groups + 1);
+  program.backtracking = needsBacktracking(ast.root);
+  try {
+    Compiler compiler(program);
+    program.code.push_back({OpCode::Save, 0, 0});
+    compiler.emit(ast.root);
+    program.code.push_back({OpCode::Save, 0, 1});
+    program.code.push_back({OpCode::Match});
+  } catch (const TooLarge &) {
+    return std::unexpected("pattern too large once repetitions are expanded");
+  }
+  program.anchored = program.code[1].op == OpCode::LineBegin;
+  program.prefilter = buildPrefilter(ast.root);
+  return program;
+}
+
+auto joinPrograms(std::span<const Program *const> programs) -> Program {
+  Program joined;
+  joined.slots = 0;
+  if (programs.empty()) {
+    joined.code.push_back({OpCode::Jump, 0, 0}); // Never matches
+    return joined;
+  }
+
+  // Entry: a Split to each program, then a Jump to the last one
+  auto head = programs.size();
+  joined.code.resize(head);
+  joined.anchored = true;
+  joined.prefilter.active = true; // Passes the first bytes of them all
+  for (size_t i = 0; i < programs.size(); ++i) {
+    const auto &program = *programs[i];
+    auto start = joined.code.size();
+    if (i + 1 < programs.size()) {
+      joined.code[i] = {OpCode::Split, 0, start, i + 1};
+    } else {
+      joined.code[i] = {OpCode::Jump, 0, start};
+    }
+
+    // Same instructions, their pcs, sets, slots and loops moved past the
+    // ones of the programs before
+    for (auto instruction : program.code) {
+      switch (instruction.op) {
+      case OpCode::Split:
+        instruction.y += start;
+        [[fallthrough]];
+      case OpCode::Jump:
+      case OpCode::Lookahead:
+      case OpCode::NegativeLookahead:
+        instruction.x += start;
+        break;
+      case OpCode::Set:
+        instruction.x += joined.sets.size();
+        break;
+      case OpCode::Save:
+        instruction.x += joined.slots;
+        break;
+      case OpCode::Backreference:
+        instruction.x += joined.slots / 2;
+        break;
+      case OpCode::Mark:
+      case OpCode::Progress:
+        instruction.x += joined.marks;
+        break;
+      case OpCode::Match:
+        instruction.x = i;
+        break;
+      default:
+        break;
+      }
+      joined.code.push_back(instruction);
+    }
+    joined.sets.insert(joined.sets.end(), program.sets.begin(),
+                       program.sets.end());
+    joined.slots += program.slots;
+    joined.marks += program.marks;
+    joined.anchored = joined.anchored && program.anchored;
+    joined.backtracking = joined.backtracking || program.backtracking;
+    joined.prefilter.first |= program.prefilter.first;
+    joined.prefilter.active =
+        joined.prefilter.active && program.prefilter.active;
+  }
+  return joined;
+}
@@ -0,0 +1,63 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Instructions the matchers run, compiled from the tree of a pattern.
+ * Counted repetitions are unrolled, and loops whose body can match the empty
+ * string stop after an empty iteration, so no loop runs without input.
+ */
+#pragma once
+
+#include "regexPrefilter.hpp"
+
+#include <expected>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class OpCode {
+  Byte,              // Next byte equals 'byte'
+  Set,               // Next byte in sets[x]
+  Split,             // Continue at x, then at y when x fails
+  Jump,              // Continue at x
+  Save,              // Capture slot x takes the position
+  Mark,              // Loop x records the position of its iteration
+  Progress,          // Fails when loop x did not advance (empty iteration)
+  LineBegin,         // ^
+  LineEnd,           // $
+  WordBoundary,      // \b
+  NotWordBoundary,   // \B
+  Backreference,     // Text of group x again
+  Lookahead,         // Body at the next instruction, continue at x after it
+  NegativeLookahead, // Same, continues when the body does not match
+  Match,             // x: index of the pattern in a joined program
+};
+
+struct Instruction {
+  OpCode op = OpCode::Match;
+  unsigned char byte = 0;
+  size_t x = 0;
+  size_t y = 0;
+};
+
+struct Program {
+  std::vector<Instruction> code;
+  std::vector<ByteSet> sets;
+  size_t slots = 2;          // Start and end of the match, then of each group
+  size_t marks = 0;          // Loops whose body can match the empty string
+  bool anchored = false;     // Starts with ^: only tried at position 0
+  bool backtracking = false; // Backreferences or lookahead
+  Prefilter prefilter;       // Where a match can start
+};
+
+// Function checks if a byte is part of words for \b (letters, digits, '_')
+inline auto isWordByte(unsigned char c) -> bool {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+// Function compiles a parsed pattern (error when it is too large)
+auto compileProgram(const Ast &ast) -> std::expected<Program, std::string>;
+
+// Function joins programs into one that runs them side by side, each one
+// ending on a Match whose x is its index in 'programs'
+auto joinPrograms(std::span<const Program *const> programs) -> Program;
@@ -0,0 +1,85 @@
+#include "regexSet.hpp"
+#include "regexAutomaton.hpp"
+
+#include <algorithm>
+#include <format>
+
+auto RegexSet::compile(std::span<const std::string> patterns)
+    -> std::expected<RegexSet, std::string> {
+  RegexSet set;
+  std::vector<const Program *> programs;
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    auto regex = Regex::compile(patterns[i]);
+    if (!regex) {
+      return std::unexpected(std::format("pattern {}: {}", i, regex.error()));
+    }
+    set.regexes.push_back(std::move(*regex));
+  }
+  for (size_t i = 0; i < set.regexes.size(); ++i) {
+    const auto &program = set.regexes[i].program;
+    if (dfaSupports(program)) {
+      set.joined.push_back(i);
+      programs.push_back(&program);
+    }
+  }
+  set.program = joinPrograms(programs);
+  return set;
+}
+
+auto RegexSet::scan(std::string_view text, const Budget &budget) const
+    -> SetResult {
+  SetResult result;
+
+  // One pass for the joined patterns, the others are always searched
+  std::vector<bool> candidates(regexes.size(), true);
+  if (!joined.empty()) {
+    std::vector<bool> matched(joined.size(), false);
+    auto pass = dfaScanJoined(program, text, budget, matched);
+    result.steps = pass.steps;
+    if (pass.status == SearchStatus::Timeout) {
+      result.status = SearchStatus::Timeout;
+      return result;
+    }
+    for (size_t i = 0; i < joined.size(); ++i) {
+      candidates[joined[i]] = matched[i];
+    }
+  }
+
+  for (size_t i = 0; i < regexes.size(); ++i) {
+    if (candidates[i]) {
+      collect(i, text, budget, result);
+      if (result.status == SearchStatus::Timeout) {
+        break;
+      }
+    }
+  }
+
+  std::ranges::sort(result.matches, [](const auto &a, const auto &b) {
+    return a.position != b.position ? a.position < b.position
+                                    : a.pattern < b.pattern;
+  });
+  if (result.status != SearchStatus::Timeout && !result.matches.empty()) {
+    result.status = SearchStatus::Found;
+  }
+  return result;
+}
+
+void RegexSet::collect(size_t index, std::string_view text,
+                       const Budget &budget, SetResult &result) const {
+  for (size_t from = 0; from <= text.size();) {
+    Budget rest = budget;
+    rest.max_steps -= std::min(rest.max_steps, result.steps);
+    auto found = regexes[index].search(text, rest, from);
+    result.steps += found.steps;
+    if (found.status == SearchStatus::Timeout) {
+      result.status = SearchStatus::Timeout;
+      return;
+    }
+    if (found.status == SearchStatus::NotFound) {
+      return;
+    }
+    result.matches.push_back({index, found.position, found.length});
+    // After an empty match, the next one starts further
+    from = found.position + std::max<size_t>(found.length, 1);
+  }
+}
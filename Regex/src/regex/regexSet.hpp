@@ -0,0 +1,58 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Several patterns searched over the same text together. The patterns the
+ * lazy DFA can run are joined into one program, and a single pass over the
+ * text tells which of them match at all. Only those are searched again to
+ * find where, so a text that most patterns do not match is read once, not
+ * once per pattern.
+ */
+#pragma once
+
+#include "regexEngine.hpp"
+
+#include <span>
+#include <vector>
+
+// A match of one pattern of a RegexSet
+struct SetMatch {
+  size_t pattern = 0; // Index in the set
+  size_t position = 0;
+  size_t length = 0;
+};
+
+struct SetResult {
+  SearchStatus status = SearchStatus::NotFound; // Found: at least one match
+  std::vector<SetMatch> matches;                // By position, then pattern
+  size_t steps = 0;                             // Spent by the matchers
+};
+
+class RegexSet {
+public:
+  // Function compiles the patterns (error message of the first invalid one)
+  static auto compile(std::span<const std::string> patterns)
+      -> std::expected<RegexSet, std::string>;
+
+  // Function finds the matches of every pattern: for each one, the matches
+  // search() finds one after the other, each starting where the last ended
+  // (on Timeout, the ones found until then)
+  auto scan(std::string_view text, const Budget &budget = {}) const
+      -> SetResult;
+
+  auto size() const -> size_t { return regexes.size(); }
+
+  auto pattern(size_t index) const -> const std::string & {
+    return regexes[index].pattern();
+  }
+
+private:
+  RegexSet() = default;
+
+  // Function adds the matches of one pattern to 'result'
+  void collect(size_t index, std::string_view text, const Budget &budget,
+               SetResult &result) const;
+
+  std::vector<Regex> regexes;
+  std::vector<size_t> joined; // Patterns of 'program', in order
+  Program program;
+};
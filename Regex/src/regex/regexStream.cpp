@@ -0,0 +1,95 @@
+#include "regexStream.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+namespace {
+
+// Function searches a file the generator owns
+auto streamFile(const Regex &regex, std::ifstream file, Budget budget,
+                StreamOptions options) -> std::generator<StreamMatch> {
+  for (auto &&match : searchStream(regex, file, budget, options)) {
+    co_yield match;
+  }
+}
+
+} // namespace
+
+auto searchStream(const Regex &regex, std::istream &input, Budget budget,
+                  StreamOptions options) -> std::generator<StreamMatch> {
+  auto chunk_size = std::max<size_t>(options.chunk_size, 1);
+  auto window = std::max<size_t>(options.window, 1);
+  std::string buffer;
+  size_t base = 0; // Offset of the buffer in the input
+  size_t from = 0; // Where the next search starts in the buffer
+  size_t steps = 0;
+  bool end = false;
+
+  while (!end) {
+    auto size = buffer.size();
+    buffer.resize(size + chunk_size);
+    input.read(buffer.data() + size, static_cast<std::streamsize>(chunk_size));
+    buffer.resize(size + static_cast<size_t>(input.gcount()));
+    end = !input;
+
+    // A match starting before this is final: one starting earlier, or
+    // ending later, would be longer than the window
+    auto settled = end ? std::string_view::npos
+                       : buffer.size() - std::min(window, buffer.size());
+
+    bool wait = false; // A match reaches the end of the buffer
+    while (from < settled && from <= buffer.size()) {
+      Budget rest = budget;
+      rest.max_steps -= std::min(rest.max_steps, steps);
+      auto found = regex.search(buffer, rest, from);
+      steps += found.steps;
+      if (found.status == SearchStatus::Timeout) {
+        co_yield StreamMatch{SearchStatus::Timeout, base + from, {}};
+        co_return;
+      }
+      if (found.status == SearchStatus::NotFound ||
+          found.position >= settled) {
+        break; // Searched again once more input is read
+      }
+      // Decided at the end of the buffer ($, \b, a lookahead or a longer
+      // match could see more input): searched again once more is read,
+      // dropped when it could no longer fit in the window
+      if (!end && found.hit_end) {
+        if (buffer.size() - found.position <= window) {
+          from = found.position;
+          wait = true;
+        }
+        break;
+      }
+      co_yield StreamMatch{
+          SearchStatus::Found, base + found.position,
+          std::string_view(buffer).substr(found.position, found.length)};
+      // After an empty match, the next one starts further
+      from = found.position + std::max<size_t>(found.length, 1);
+    }
+    if (end) {
+      break;
+    }
+
+    // Keep the window, and one byte before it for ^ and \b to see that it
+    // is not the start of the input
+    if (!wait) {
+      from = std::max(from, settled);
+    }
+    auto dropped = from - std::min<size_t>(from, 1);
+    buffer.erase(0, dropped);
+    base += dropped;
+    from -= dropped;
+  }
+}
+
+auto searchFile(const Regex &regex, const std::string &path, Budget budget,
+                StreamOptions options)
+    -> std::expected<std::generator<StreamMatch>, std::string> {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::unexpected(std::format("cannot open {}", path));
+  }
+  return streamFile(regex, std::move(file), budget, options);
+}
@@ -0,0 +1,43 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Search over inputs too large to hold in memory, such as multi-GB logs.
+ * The input is read in fixed-size chunks; the end of each chunk is kept as
+ * a window searched again with the next one, so matches across a boundary
+ * are found. Matches are yielded one at a time with their offset in the
+ * input, and memory stays bounded by the chunk size and the window,
+ * whatever the size of the input.
+ */
+#pragma once
+
+#include "regexEngine.hpp"
+
+#include <expected>
+#include <generator>
+#include <istream>
+
+struct StreamOptions {
+  size_t chunk_size = 1 << 20; // Bytes read at a time
+  size_t window = 64 << 10;    // Longest match always found whole
+};
+
+struct StreamMatch {
+  SearchStatus status = SearchStatus::Found; // Timeout: the last, no match
+  size_t offset = 0;                         // Of the match in the input
+  std::string_view text; // Valid until the next match is asked for
+};
+
+// Function yields the matches search() would find one after the other in
+// the whole input, reading it by chunks ('regex' and 'input' must outlive
+// the generator). Exact for matches that, with the text their assertions
+// look at, fit in the window; longer ones, and those starting inside them,
+// may be missed, but no match is yielded that the input does not contain.
+// Memory stays under two chunks plus the window.
+auto searchStream(const Regex &regex, std::istream &input, Budget budget = {},
+                  StreamOptions options = {}) -> std::generator<StreamMatch>;
+
+// Function opens a file and searches it as a stream (error message when it
+// cannot be opened)
+auto searchFile(const Regex &regex, const std::string &path,
+                Budget budget = {}, StreamOptions options = {})
+    -> std::expected<std::generator<StreamMatch>, std::string>;
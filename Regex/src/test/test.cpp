@@ -0,0 +1,659 @@
+/*
+ * Training Regex and ReDoS (Regular Expression Denial of Service)
+ *
+ * Tests of the matching engine against std::regex_search (ECMAScript), the
+ * reference the engine replaced.
+ */
+
+#include "../regex/regexAnalyzer.hpp"
+#include "../regex/regexCache.hpp"
+#include "../regex/regexEngine.hpp"
+#include "../regex/regexMetrics.hpp"
+#include "../regex/regexParser.hpp"
+#include "../regex/regexPool.hpp"
+#include "../regex/regexSet.hpp"
+#include "../regex/regexStream.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <optional>
+#include <print>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// --- Declaration ---
+void test();
+void test1();
+void test2();
+void test3();
+void test4();
+void test5();
+void test6();
+void test7();
+void test8();
+void test9();
+void test10();
+
+// --- Main ---
+auto main() -> int {
+
+  test();
+
+  return 0;
+}
+
+// --- Reference ---
+
+// Position and length of the match std::regex_search finds at or after
+// 'from' (nullopt without a match, or when std::regex rejects the pattern)
+auto reference(const std::regex &rgx, std::string_view text, size_t from)
+    -> std::optional<std::pair<size_t, size_t>> {
+  std::match_results<std::string_view::const_iterator> match;
+  auto flags = from > 0 ? std::regex_constants::match_prev_avail
+                        : std::regex_constants::match_default;
+  if (!std::regex_search(text.begin() + static_cast<std::ptrdiff_t>(from),
+                         text.end(), match, rgx, flags)) {
+    return std::nullopt;
+  }
+  return std::pair{from + static_cast<size_t>(match.position(0)),
+                   static_cast<size_t>(match.length(0))};
+}
+
+// Function checks that the engine finds the same match as std::regex
+auto sameAsStd(std::string_view pattern, std::string_view text,
+               size_t from = 0) -> bool {
+  auto compiled = Regex::compile(pattern);
+  assert(compiled);
+  std::regex rgx{std::string(pattern), std::regex::ECMAScript};
+  auto expected = reference(rgx, text, from);
+  auto result = compiled->search(text, {}, from);
+  if (!expected) {
+    return result.status == SearchStatus::NotFound;
+  }
+  return result.status == SearchStatus::Found &&
+         result.position == expected->first &&
+         result.length == expected->second;
+}
+
+// Function checks if a tree uses a construct where libstdc++ does not follow
+// ECMAScript: an optional or repeated part that can match the empty string
+// (an empty iteration must fail), or ^, $, \b inside a lookahead (read as
+// if the text started there)
+auto differsInStd(const Node &node, bool lookahead = false) -> bool {
+  if (node.type == NodeType::Repeat && node.max > 0 &&
+      matchesEmpty(node.children.front())) {
+    return true;
+  }
+  if (lookahead && (node.type == NodeType::LineBegin ||
+                    node.type == NodeType::LineEnd ||
+                    node.type == NodeType::WordBoundary)) {
+    return true;
+  }
+  lookahead = lookahead || node.type == NodeType::Lookahead;
+  return std::ranges::any_of(node.children, [lookahead](const Node &child) {
+    return differsInStd(child, lookahead);
+  });
+}
+
+// Matches found by streaming 'text' (offset and length), nullopt when the
+// budget runs out
+auto streamed(const Regex &regex, const std::string &text,
+              StreamOptions options, Budget budget = {})
+    -> std::optional<std::vector<std::pair<size_t, size_t>>> {
+  std::istringstream input(text);
+  std::vector<std::pair<size_t, size_t>> matches;
+  for (auto &&match : searchStream(regex, input, budget, options)) {
+    if (match.status == SearchStatus::Timeout) {
+      return std::nullopt;
+    }
+    matches.emplace_back(match.offset, match.text.size());
+  }
+  return matches;
+}
+
+// Matches found by searching the whole text one after the other
+auto searched(const Regex &regex, std::string_view text, Budget budget = {})
+    -> std::optional<std::vector<std::pair<size_t, size_t>>> {
+  std::vector<std::pair<size_t, size_t>> matches;
+  for (size_t from = 0; from <= text.size();) {
+    auto result = regex.search(text, budget, from);
+    if (result.status == SearchStatus::Timeout) {
+      return std::nullopt;
+    }
+    if (result.status == SearchStatus::NotFound) {
+      break;
+    }
+    matches.emplace_back(result.position, result.length);
+    from = result.position + std::max<size_t>(result.length, 1);
+  }
+  return matches;
+}
+
+// Random pattern over 'a' and 'b', with the constructs of the parser
+class PatternMaker {
+public:
+  explicit PatternMaker(unsigned seed) : rng(seed) {}
+
+  auto make() -> std::string {
+    groups = 0;
+    closed.clear();
+    return alternation(0);
+  }
+
+private:
+  auto chance(int percent) -> bool {
+    return std::uniform_int_distribution<int>(0, 99)(rng) < percent;
+  }
+
+  auto pick(size_t count) -> size_t {
+    return std::uniform_int_distribution<size_t>(0, count - 1)(rng);
+  }
+
+  auto alternation(int depth) -> std::string {
+    auto result = sequence(depth);
+    while (chance(20)) {
+      result += "|" + sequence(depth);
+    }
+    return result;
+  }
+
+  auto sequence(int depth) -> std::string {
+    std::string result;
+    for (auto n = pick(4); n > 0; --n) {
+      result += quantified(depth);
+    }
+    return result;
+  }
+
+  auto quantified(int depth) -> std::string {
+    auto atom = this->atom(depth);
+    if (assertion || !chance(40)) {
+      return atom; // Assertions are not repeated
+    }
+    static constexpr std::string_view quantifiers[] = {
+        "*", "+", "?", "{2}", "{0,2}", "{1,}", "{1,3}"};
+    atom += quantifiers[pick(std::size(quantifiers))];
+    if (chance(25)) {
+      atom += "?"; // Lazy
+    }
+    return atom;
+  }
+
+  // Sets 'assertion' when the atom is one
+  auto atom(int depth) -> std::string {
+    static constexpr std::string_view atoms[] = {"a",    "b",   ".",
+                                                 "[ab]", "[^a]", "\\w"};
+    assertion = false;
+    auto kind = pick(depth < 3 ? 10 : 6);
+    if (kind < 6) {
+      return std::string(atoms[kind]);
+    }
+    if (kind == 6 && !closed.empty() && backreferences) {
+      return "\\" + std::to_string(closed[pick(closed.size())]);
+    }
+    if (kind == 7 && assertions) {
+      static constexpr std::string_view anchors[] = {"^", "$", "\\b", "\\B"};
+      auto anchor = std::string(anchors[pick(4)]);
+      if (chance(50)) {
+        anchor = (chance(50) ? "(?=" : "(?!") + alternation(depth + 1) + ")";
+      }
+      assertion = true;
+      return anchor;
+    }
+    if (chance(30)) {
+      return "(?:" + alternation(depth + 1) + ")";
+    }
+    auto index = ++groups;
+    auto inner = alternation(depth + 1);
+    closed.push_back(index);
+    return "(" + inner + ")";
+  }
+
+public:
+  bool backreferences = false;
+  bool assertions = false;
+
+private:
+  std::mt19937 rng;
+  bool assertion = false;
+  size_t groups = 0;
+  std::vector<size_t> closed;
+};
+
+// --- Test ---
+void test() {
+  test1(); // Fixed patterns against std::regex
+  test2(); // Random patterns against std::regex
+  test3(); // Backreferences rejected as std::regex does
+  test4(); // Backends and budgets
+  test5(); // Searches starting inside the text
+  test6(); // Streams read by chunks
+  test7(); // Growth found by the analyzer
+  test8(); // Pattern sets scanned together
+  test9(); // Shared pool and pattern cache
+  test10(); // Search metrics
+
+  std::println("Test completed!");
+}
+
+void test1() {
+  const std::vector<std::pair<std::string_view, std::string_view>> cases{
+      {"a|ab", "xab"},
+      {"ab|a", "xab"},
+      {"a*?b", "aaab"},
+      {"a+?", "aaa"},
+      {"(a|ab)(c|bcd)(d*)", "abcd"},
+      {"[a-c]+", "zzcabz"},
+      {"[^a-c]+", "abcxyz"},
+      {"\\d{2,3}", "a1b1234"},
+      {"\\w+@\\w+\\.com", "mail: me@host.com!"},
+      {"\\s+", "a \t\nb"},
+      {"^b", "ab\nb"},
+      {"b$", "ab\nb"},
+      {"\\bfoo\\b", "foobar foo"},
+      {"\\Boo", "foo"},
+      {"(a)\\1", "aba aa"},
+      {"(a|b)\\1+", "abbb"},
+      {"a(?=b)", "acab"},
+      {"a(?!b)", "abac"},
+      {"(?:ab){2}", "abababab"},
+      {"x{0}y", "xy"},
+      {"(a*)*b", "aaab"},
+      {"(a*)+", "b"},
+      {"(a|)+b", "aab"},
+      {".*", "line\nnext"},
+      {"[.]", "a.b"},
+      {"\\x41\\u0042", "xAB"},
+      {"[\\]]", "a]b"},
+      {"", "abc"},
+      {"phone\\d*", "call phone123 now"},
+      {"\\+\\d{2}\\s\\(\\d{2}\\)\\s\\d{4,5}-\\d{4}", "+55 (11) 91234-5678"}};
+  for (auto [pattern, text] : cases) {
+    assert(sameAsStd(pattern, text));
+  }
+
+  // Where std::regex departs from ECMAScript: results of the standard
+  struct Known {
+    std::string_view pattern;
+    std::string_view text;
+    size_t position;
+    size_t length;
+  };
+  const std::vector<Known> known{
+      {".{0,2}?(?:|a\\w){0,2}", "aaabab", 0, 4}, // empty iterations fail
+      {"(|[ab]b{2}?)+", "abbaaaaa", 0, 3},
+      {"((b.)?\?()){1,}", "b a", 0, 2}, // "\?": no ??( trigraph
+      {"(a?){2}a{2}", "aa", 0, 2},
+      {"\\w[ab](?![^a]|^ab)", "ababb", 0, 2}, // ^ is not at a line start
+      {"a(?=\\b)", "a b", 0, 1}};
+  for (auto [pattern, text, position, length] : known) {
+    auto result = Regex::compile(pattern)->search(text);
+    assert(result.status == SearchStatus::Found);
+    assert(result.position == position && result.length == length);
+  }
+  assert(Regex::compile("b(?=^)")->search("ab").status ==
+         SearchStatus::NotFound);
+}
+
+void test2() {
+  // Without backreferences and lookahead: the linear-time automata
+  PatternMaker maker(2);
+  std::mt19937 rng(2);
+  std::uniform_int_distribution<size_t> length(0, 12);
+  std::uniform_int_distribution<int> letter(0, 3);
+  auto text = [&] {
+    std::string s;
+    for (auto n = length(rng); n > 0; --n) {
+      s += "aab "[letter(rng)];
+    }
+    return s;
+  };
+
+  for (int round = 0; round < 3; ++round) {
+    maker.backreferences = round == 2;
+    maker.assertions = round >= 1;
+    for (int n = 0; n < 2000; ++n) {
+      auto pattern = maker.make();
+      if (differsInStd(parsePattern(pattern)->root)) {
+        continue;
+      }
+      for (int k = 0; k < 4; ++k) {
+        auto sample = text();
+        if (!sameAsStd(pattern, sample)) {
+          std::println(stderr, "Differs from std::regex: /{}/ on \"{}\"", pattern,
+                       sample);
+          assert(false);
+        }
+      }
+    }
+  }
+}
+
+void test3() {
+  // Only groups already closed can be referenced
+  assert(Regex::compile("(a)\\1"));
+  assert(Regex::compile("(a)(b\\1)"));
+  assert(Regex::compile("(a)|\\1"));
+  for (auto pattern : {"\\1(a)", "(a\\1)", "b(\\1)c", "((a)\\1)", "(a)\\2",
+                       "\\1"}) {
+    assert(!Regex::compile(pattern));
+    bool rejected = false;
+    try {
+      std::regex rgx(pattern, std::regex::ECMAScript);
+    } catch (const std::regex_error &) {
+      rejected = true;
+    }
+    assert(rejected);
+  }
+  auto error = parsePattern("(a\\1)");
+  assert(!error && error.error().message == "backreference to an open group");
+}
+
+void test4() {
+  // Automaton for plain patterns, backtracking only when needed
+  assert(Regex::compile("(a+)+b")->backend() == Backend::Automaton);
+  assert(Regex::compile("(a)\\1")->backend() == Backend::Backtracking);
+  assert(Regex::compile("a(?=b)")->backend() == Backend::Backtracking);
+
+  // Linear on the classic ReDoS patterns
+  std::string text(5000, 'a');
+  for (auto pattern : {"(a+)+b", "(a|a)*b", "(a*)*b", "(a|aa)+$b"}) {
+    auto result = Regex::compile(pattern)->search(text);
+    assert(result.status == SearchStatus::NotFound);
+    assert(result.steps < 100 * text.size());
+  }
+
+  // A backtracking search stops at its budget
+  auto slow = Regex::compile("(a*)*(?=b)\\1");
+  Budget budget;
+  budget.max_steps = 10000;
+  assert(slow->search(text, budget).status == SearchStatus::Timeout);
+}
+
+void test5() {
+  // Anchors and \b look at the text before 'from'
+  std::string_view text = "ab ab\nab";
+  for (auto pattern : {"ab", "^ab", "\\bb", "\\Bb", "b$", "[ab]+"}) {
+    for (size_t from = 0; from <= text.size(); ++from) {
+      assert(sameAsStd(pattern, text, from));
+    }
+  }
+}
+
+void test6() {
+  // A match decided at the end of a chunk is never made up
+  std::string run = std::string(40, 'b') + "a";
+  auto tail = Regex::compile("b+$");
+  assert(streamed(*tail, run, {7, 16})->empty());
+  std::string large = std::string(100000, 'b') + "a";
+  assert(streamed(*tail, large, {})->empty());
+  // Too long to be found whole: the end of it, found from the window, is
+  auto ahead = Regex::compile("b+(?=a)");
+  auto ends = streamed(*ahead, run, {7, 16});
+  for (auto [offset, length] : *ends) {
+    assert(offset + length == run.size() - 1);
+  }
+
+  // Matches that fit in the window are the ones of the whole text: short
+  // lines, and nothing but [^a] and lookahead reading past a line end
+  PatternMaker maker(6);
+  maker.backreferences = true;
+  maker.assertions = true;
+  std::mt19937 rng(6);
+  std::uniform_int_distribution<size_t> width(1, 5);
+  std::uniform_int_distribution<int> letter(0, 2);
+  Budget budget;
+  budget.max_steps = 1000000; // Random patterns can be exponential
+  for (int n = 0; n < 1000; ++n) {
+    auto regex = Regex::compile(maker.make());
+    std::string text;
+    while (text.size() < 100) {
+      for (auto k = width(rng); k > 0; --k) {
+        text += "aab"[letter(rng)];
+      }
+      text += '\n';
+    }
+    auto whole = searched(*regex, text, budget);
+    auto chunks = streamed(*regex, text, {5, 16}, budget);
+    if (!whole || !chunks) {
+      continue;
+    }
+    auto &pattern = regex->pattern();
+    bool fits = pattern.find("(?=") == std::string::npos &&
+                pattern.find("(?!") == std::string::npos &&
+                pattern.find("[^a]") == std::string::npos;
+    // Otherwise some may be missed, but the others are in the text
+    bool real = std::ranges::all_of(*chunks, [&](auto match) {
+      auto result = regex->search(text, {}, match.first);
+      return result.position == match.first && result.length == match.second;
+    });
+    if ((fits && chunks != whole) || !real) {
+      std::println(stderr, "Stream differs: /{}/ on \"{}\"", pattern, text);
+      assert(false);
+    }
+  }
+}
+
+void test7() {
+  auto growth = [](std::string_view pattern) {
+    auto analysis = analyzePattern(pattern);
+    assert(analysis);
+    return std::pair{analysis->effective(), analysis->degree};
+  };
+  assert(growth("\\+\\d{2}\\s\\(\\d{2}\\)\\s\\d{4,5}-\\d{4}(?=$)").first ==
+         Growth::Linear);
+  assert(growth("a{20}(?=b)").first == Growth::Linear);
+  assert(growth("(a?){0,20}(?=b)").first == Growth::Linear);
+  assert(growth("(a+)+b").first == Growth::Linear); // On the automata
+  assert(growth("(a+)+(?=b)").first == Growth::Exponential);
+  assert(growth("\\d+\\d+(?=x)") == std::pair(Growth::Polynomial, size_t{2}));
+  assert(growth("\\d{1,3}\\d+(?=x)") ==
+         std::pair(Growth::Polynomial, size_t{2}));
+
+  // Counted repetitions whose iterations may be empty: each one is a choice
+  std::string text(20, 'a');
+  Budget budget;
+  budget.max_steps = 1000000;
+  for (auto pattern : {"(a?){20}a{20}(?=b)", "(a?){20}a{20}\\1"}) {
+    assert(growth(pattern) == std::pair(Growth::Polynomial, size_t{20}));
+    auto result = Regex::compile(pattern)->search(text, budget);
+    assert(result.status == SearchStatus::Timeout);
+  }
+  assert(growth("(a?){24}a{24}(?=b)") ==
+         std::pair(Growth::Polynomial, size_t{24}));
+
+  // A backreference matches what its group can: (a)(?:\1|a)+ is (a|a)+
+  assert(growth("(a)(?:\\1|a)+b").first == Growth::Exponential);
+  assert(growth("(a)(?:\\1+)+").first == Growth::Exponential);
+  assert(growth("(a)(?:a|\\1)+(?=b)").first == Growth::Exponential);
+  assert(growth("(a)\\1*a*b") == std::pair(Growth::Polynomial, size_t{2}));
+  assert(growth("(a)(b)\\1\\2").first == Growth::Linear);
+  std::string as(18, 'a');
+  auto blowup = Regex::compile("(a)(?:\\1|a)+b")->search(as, budget);
+  assert(blowup.status == SearchStatus::Timeout);
+}
+
+void test8() {
+  // The matches of each pattern searched alone, by position then pattern
+  auto expected = [](const RegexSet &set, std::string_view text) {
+    std::vector<SetMatch> matches;
+    for (size_t i = 0; i < set.size(); ++i) {
+      auto alone = searched(*Regex::compile(set.pattern(i)), text);
+      for (auto [position, length] : *alone) {
+        matches.push_back({i, position, length});
+      }
+    }
+    std::ranges::sort(matches, [](const auto &a, const auto &b) {
+      return a.position != b.position ? a.position < b.position
+                                      : a.pattern < b.pattern;
+    });
+    return matches;
+  };
+  auto same = [](const std::vector<SetMatch> &a,
+                 const std::vector<SetMatch> &b) {
+    return std::ranges::equal(a, b, [](const auto &x, const auto &y) {
+      return x.pattern == y.pattern && x.position == y.position &&
+             x.length == y.length;
+    });
+  };
+
+  // Joined patterns with backtracking and anchored ones
+  std::vector<std::string> fixed{"a+b",   "(a)\\1", "^a",  "a(?=b)",
+                                 "b$",    "(a|b)b",  "x",   "[ab]{2,3}",
+                                 "\\bab", "()",      "b*?a"};
+  auto set = RegexSet::compile(fixed);
+  assert(set && set->size() == fixed.size());
+  for (std::string_view text : {"", "ab", "aab baab", "bba", "xaax", "b"}) {
+    auto result = set->scan(text);
+    assert(same(result.matches, expected(*set, text)));
+    assert((result.status == SearchStatus::Found) == !result.matches.empty());
+  }
+  assert(!RegexSet::compile(std::vector<std::string>{"a", "(b"}));
+
+  // Random sets: relocated pcs, sets, slots and marks of the joined program
+  PatternMaker maker(8);
+  std::mt19937 rng(8);
+  std::uniform_int_distribution<size_t> count(1, 6);
+  std::uniform_int_distribution<int> letter(0, 3);
+  for (int n = 0; n < 500; ++n) {
+    maker.backreferences = n % 2 == 0;
+    maker.assertions = n % 3 == 0;
+    std::vector<std::string> patterns;
+    for (auto k = count(rng); k > 0; --k) {
+      patterns.push_back(maker.make());
+    }
+    auto random = RegexSet::compile(patterns);
+    std::string text;
+    for (int k = 0; k < 20; ++k) {
+      text += "aab "[letter(rng)];
+    }
+    if (!same(random->scan(text).matches, expected(*random, text))) {
+      std::println(stderr, "Set differs on \"{}\"", text);
+      for (const auto &pattern : patterns) {
+        std::println(stderr, "  /{}/", pattern);
+      }
+      assert(false);
+    }
+  }
+}
+
+void test9() {
+  // Every index runs once, nested use from inside a task does not block
+  ThreadPool pool(3);
+  std::vector<std::atomic<int>> runs(100);
+  pool.parallel_for(runs.size(), [&runs](size_t i) { ++runs[i]; });
+  assert(std::ranges::all_of(runs, [](const auto &n) { return n == 1; }));
+  std::atomic<int> count{0};
+  pool.parallel_for(8, [&pool, &count](size_t) {
+    pool.parallel_for(8, [&count](size_t) { ++count; });
+  });
+  assert(count == 64);
+
+  // A throwing task does not stop the others, its exception reaches the caller
+  std::atomic<int> finished{0};
+  bool thrown = false;
+  try {
+    pool.parallel_for(16, [&finished](size_t i) {
+      if (i % 4 == 0) {
+        throw std::runtime_error("task failed");
+      }
+      ++finished;
+    });
+  } catch (const std::runtime_error &) {
+    thrown = true;
+  }
+  assert(thrown && finished == 12);
+
+  // Compiled and checked once, the least recently used dropped
+  size_t checks = 0;
+  PatternCache cache(
+      [&checks](std::string_view pattern) {
+        ++checks;
+        return pattern == "(a+)+" ? std::string("unsafe") : std::string();
+      },
+      2);
+  auto first = cache.get("a+");
+  assert(first->regex && first->warning.empty());
+  assert(cache.get("a+") == first);
+  assert(cache.get("(a+)+")->warning == "unsafe");
+  assert(!cache.get("(b")->regex); // Drops "a+", the least recently used
+  auto stats = cache.stats();
+  assert(stats.hits == 1 && stats.misses == 3);
+  assert(stats.size == 2 && stats.capacity == 2);
+  assert(cache.get("(a+)+")->warning == "unsafe");
+  assert(checks == 3);
+  assert(cache.get("a+") != first); // Compiled again
+  assert(checks == 4);
+  stats = cache.stats();
+  assert(stats.hits == 2 && stats.misses == 4 && stats.size == 2);
+}
+
+void test10() {
+  using std::chrono::nanoseconds;
+
+  // One bucket per value under 8 ns, then within a quarter; the max exact
+  LatencyHistogram exact;
+  assert(exact.percentile(0.5) == nanoseconds(0));
+  for (int ns = 0; ns < 8; ++ns) {
+    exact.record(nanoseconds(ns));
+  }
+  for (int k = 1; k <= 8; ++k) {
+    assert(exact.percentile(k / 8.0) == nanoseconds(k - 1));
+  }
+  for (int64_t power = 8; power <= (int64_t{1} << 40); power *= 2) {
+    LatencyHistogram histogram;
+    for (int k = 0; k < 100; ++k) {
+      histogram.record(nanoseconds(power + power / 8));
+    }
+    histogram.record(nanoseconds(power * 1000));
+    for (auto p : {histogram.percentile(0.5), histogram.percentile(0.99)}) {
+      assert(p >= nanoseconds(power + power / 8));
+      assert(p < nanoseconds(power + power / 4));
+    }
+    assert(histogram.max() == nanoseconds(power * 1000));
+    assert(histogram.percentile(1.0) == histogram.max());
+  }
+  LatencyHistogram largest;
+  largest.record(nanoseconds::max());
+  largest.record(nanoseconds(-5)); // Counted as zero
+  assert(largest.percentile(0.5) == nanoseconds(0));
+  assert(largest.percentile(1.0) == nanoseconds::max());
+  assert(largest.count() == 2 && largest.sum() == nanoseconds::max());
+
+  // Counters per pattern, past the capacity together
+  MetricsRegistry registry(2);
+  registry.record("a", SearchStatus::Found, 10, nanoseconds(100));
+  registry.record("b", SearchStatus::Timeout, 20, nanoseconds(5000));
+  registry.record("c", SearchStatus::Found, 30, nanoseconds(7));
+  registry.record("d", SearchStatus::NotFound, 40, nanoseconds(9));
+  registry.record("a", SearchStatus::NotFound, 5, nanoseconds(300));
+  auto a = registry.get("a");
+  assert(a && a->searches == 2 && a->matches == 1 && a->timeouts == 0);
+  assert(a->bytes == 15 && a->total == nanoseconds(400));
+  assert(a->max == nanoseconds(300));
+  assert(registry.get("b")->timeouts == 1);
+  assert(!registry.get("c") && !registry.get("d"));
+  auto other = registry.get(MetricsRegistry::other_patterns);
+  assert(other && other->searches == 2 && other->matches == 1);
+  assert(other->bytes == 70 && other->max == nanoseconds(9));
+  auto all = registry.all();
+  assert(all.size() == 3 && all.front().pattern == "b"); // The most time
+
+  // Patterns escaped in the JSON output
+  MetricsRegistry json;
+  json.record("q\"\\\x01\n\t", SearchStatus::Found, 3, nanoseconds(2));
+  auto out = json.toJson();
+  assert(out.find(R"("pattern": "q\"\\\u0001\n\t")") != std::string::npos);
+  auto latency = R"("latency_ns": {"total": 2, "p50": 2, "p99": 2, "max": 2})";
+  assert(out.find(latency) != std::string::npos);
+  json.clear();
+  assert(json.toJson() == "{\"patterns\": [\n]}");
+}
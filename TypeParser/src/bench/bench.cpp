@@ -0,0 +1,189 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Throughput of the parser on synthetic groups, written as JSON:
+ *   bench_typeParser [max_elements] > bench.json
+ */
+
+#include "../typeParser/typeInstrument.hpp"
+#include "../typeParser/typeParser.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <print>
+#include <random>
+
+// --- Allocation counter ---
+#ifdef TYPE_PARSER_INSTRUMENT
+
+// Instrumented builds link typeAllocations.cpp, which replaces operator new
+auto allocationCount() -> size_t { return thread_allocations().count; }
+
+#else
+
+namespace {
+std::atomic<size_t> allocations{0};
+} // namespace
+
+auto operator new(std::size_t size) -> void * {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto *p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+auto allocationCount() -> size_t {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+#endif
+
+namespace {
+
+// --- Inputs ---
+struct Input {
+  std::string_view name;
+  std::string text;
+  size_t elements;
+};
+
+auto makeInput(std::string_view name, size_t count) -> Input {
+  std::mt19937 rng(static_cast<unsigned>(count));
+  std::uniform_int_distribution<int> value(-100000, 100000);
+  std::string text = "{";
+  text.reserve(count * 16);
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      text += ", ";
+    }
+    if (name == "int") {
+      text += std::to_string(value(rng));
+    } else if (name == "float") {
+      text += std::format("{}.25", value(rng));
+    } else if (name == "dict") {
+      text += std::format("'k{}' : {}", i, value(rng));
+    } else { // mixed
+      switch (i % 4) {
+      case 0:
+        text += std::to_string(value(rng));
+        break;
+      case 1:
+        text += std::format("{}.5", value(rng));
+        break;
+      case 2:
+        text += "'c'";
+        break;
+      default:
+        text += std::format("'word{}'", i);
+      }
+    }
+  }
+  text += "}";
+  return {name, std::move(text), count};
+}
+
+// --- Measure ---
+struct Result {
+  size_t iterations = 0;
+  double seconds = 0;
+  size_t allocations = 0;
+};
+
+// Keeps the results observable, so the calls are not removed
+volatile size_t sink = 0;
+
+// Repeats the call for at least 'minimum' seconds (at least once)
+auto measure(const std::function<size_t()> &call, double minimum = 0.2)
+    -> Result {
+  using Clock = std::chrono::steady_clock;
+  Result result;
+  auto before = allocationCount();
+  auto start = Clock::now();
+  do {
+    sink = sink + call();
+    ++result.iterations;
+    result.seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+  } while (result.seconds < minimum);
+  result.allocations = allocationCount() - before;
+  return result;
+}
+
+auto measureAll(const Input &input)
+    -> std::vector<std::pair<std::string_view, Result>> {
+  // Elements as process() sees them (without the braces)
+  auto body = std::string_view(input.text).substr(1, input.text.size() - 2);
+  auto elements = split_view(body, ',');
+
+  std::vector<std::pair<std::string_view, Result>> results;
+  results.emplace_back("process", measure([&] {
+    return process(input.text).index();
+  }));
+  results.emplace_back("split", measure([&] {
+    return split(body, ",").size();
+  }));
+  results.emplace_back("trim", measure([&] {
+    size_t total = 0;
+    for (auto e : elements) {
+      total += trim(e).size();
+    }
+    return total;
+  }));
+  results.emplace_back("isNumber", measure([&] {
+    size_t total = 0;
+    for (auto e : elements) {
+      total += isNumber(e).status;
+    }
+    return total;
+  }));
+  results.emplace_back("stringviewToNumber", measure([&] {
+    size_t total = 0;
+    for (auto e : elements) {
+      total += stringviewToNumber<double>(e).index();
+    }
+    return total;
+  }));
+  return results;
+}
+
+} // namespace
+
+// --- Main ---
+auto main(int argc, char *argv[]) -> int {
+  size_t maximum = 10'000'000;
+  if (argc > 1) {
+    maximum = std::strtoull(argv[1], nullptr, 10);
+  }
+
+  std::println("{{\n  \"benchmarks\": [");
+  bool first = true;
+  for (size_t count = 100; count <= maximum; count *= 10) {
+    for (auto name : {"int", "float", "dict", "mixed"}) {
+      auto input = makeInput(name, count);
+      for (const auto &[function, result] : measureAll(input)) {
+        auto calls = static_cast<double>(result.iterations);
+        auto mb = static_cast<double>(input.text.size()) * calls / 1e6;
+        auto elements = static_cast<double>(input.elements) * calls;
+        std::print("{}    {{\"function\": \"{}\", \"input\": \"{}\", "
+                   "\"elements\": {}, \"bytes\": {}, \"iterations\": {}, "
+                   "\"mb_per_s\": {:.2f}, \"elements_per_s\": {:.0f}, "
+                   "\"allocations_per_call\": {:.2f}}}",
+                   first ? "" : ",\n", function, input.name, input.elements,
+                   input.text.size(), result.iterations, mb / result.seconds,
+                   elements / result.seconds,
+                   static_cast<double>(result.allocations) / calls);
+        first = false;
+      }
+    }
+  }
+  std::println("\n  ]\n}}");
+
+  return 0;
+}
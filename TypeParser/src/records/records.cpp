@@ -0,0 +1,114 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Record mode: parses a file holding one input per line, writes one record
+ * per line to stdout and the summary to stderr:
+ *   typeRecords <file> [threads] > records.txt
+ */
+
+#include "../typeParser/typePool.hpp"
+#include "../typeParser/typeRecords.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <iterator>
+#include <print>
+#include <string>
+
+namespace {
+
+// Names of the ParsedData types, by index
+constexpr std::array<std::string_view, 6> type_names{
+    "integer", "float", "character", "string", "dictionary", "empty"};
+
+// Output written in large blocks, the parser should not wait on stdout
+class Output {
+public:
+  ~Output() { flush(); }
+
+  void add(size_t line, const ParsedData &record) {
+    auto out = std::back_inserter(buffer);
+    std::format_to(out, "{}\t", line);
+    const auto visitor = overloads{
+        [&](const std::vector<Dict> &vec) {
+          std::format_to(out, "{}", type_names[record.index()]);
+          for (const auto &item : vec) {
+            std::format_to(out, "\t{}: {}", item.key, item.value);
+          }
+        },
+        [&](bool value) {
+          std::format_to(out, "{}", value ? "empty" : "failed");
+        },
+        [&](const auto &vec) {
+          std::format_to(out, "{}", type_names[record.index()]);
+          for (const auto &item : vec) {
+            std::format_to(out, "\t{}", item);
+          }
+        },
+    };
+    std::visit(visitor, record);
+    buffer += '\n';
+    if (buffer.size() >= block) {
+      flush();
+    }
+  }
+
+  void flush() {
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    buffer.clear();
+  }
+
+private:
+  static constexpr size_t block = size_t{1} << 20;
+  std::string buffer;
+};
+
+} // namespace
+
+// --- Main ---
+auto main(int argc, char *argv[]) -> int {
+  if (argc < 2) {
+    std::println(stderr, "Usage: {} <file> [threads]", argv[0]);
+    return 2;
+  }
+  size_t threads = 0;
+  if (argc > 2) {
+    threads = std::strtoull(argv[2], nullptr, 10);
+  }
+
+  ThreadPool pool(threads);
+  Output output;
+  auto start = std::chrono::steady_clock::now();
+  auto result = process_record_file(
+      argv[1],
+      [&output](size_t line, const ParsedData &record) {
+        output.add(line, record);
+      },
+      pool);
+  output.flush();
+  std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start;
+
+  if (std::holds_alternative<bool>(result)) {
+    std::println(stderr, "Unable to read {}", argv[1]);
+    return 1;
+  }
+  const auto &stats = std::get<RecordStats>(result);
+  std::println(stderr, "Records: {} ({} blank lines), {} bytes in {:.3f} s",
+               stats.records, stats.blank, stats.bytes, seconds.count());
+  for (size_t i = 0; i < type_names.size(); ++i) {
+    std::println(stderr, "  {}: {}", type_names[i], stats.types[i]);
+  }
+  std::println(stderr, "Failed: {}", stats.failed);
+  for (const auto &failure : stats.failures) {
+    std::println(stderr, "  line {}: {}", failure.line, failure.text);
+  }
+  if (stats.failed > stats.failures.size()) {
+    std::println(stderr, "  ... {} more", stats.failed - stats.failures.size());
+  }
+
+  return 0;
+}
@@ -2,9 +2,29 @@
  * This code focuses on training modern C++ and manipulating types and strings.
  */
 
+#include "../typeParser/typeCache.hpp"
+#include "../typeParser/typeColumns.hpp"
+#include "../typeParser/typeInstrument.hpp"
+#include "../typeParser/typeLiteral.hpp"
+#include "../typeParser/typeMemo.hpp"
 #include "../typeParser/typeParser.hpp"
+#include "../typeParser/typePool.hpp"
+#include "../typeParser/typeRecords.hpp"
+#include "../typeParser/typeScan.hpp"
+#include "../typeParser/typeStream.hpp"
+#include "../typeParser/typeTree.hpp"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
 #include <functional>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 
 // --- Declaration ---
 void test();
@@ -12,6 +32,22 @@ void test1();
 void test2();
 void test3();
 void test4(std::vector<std::vector<std::string_view>> vec);
+void test5();
+void test6();
+void test7();
+void test8();
+void test9();
+void test10();
+void test11();
+void test12();
+void test13();
+void test14();
+void test15();
+void test16();
+void test17();
+void test18();
+void test19();
+void test20();
 
 // --- Main ---
 auto main() -> int {
@@ -26,6 +62,22 @@ void test() {
   test1(); // Simple check
   test2(); // Check stringviewToNumber
   test3(); // Check stringviewToDict
+  test5(); // Check classifier against the regex predicates
+  test6(); // Check regular expression cache
+  test7(); // Check zero-copy processing
+  test8(); // Check streaming
+  test9();  // Check parallel processing
+  test10(); // Check vectorized scanning
+  test11(); // Check arena allocation
+  test12(); // Check single-pass inference
+  test13(); // Check compile-time parsing
+  test14(); // Check nested groups
+  test15(); // Check columnar dictionaries
+  test16(); // Check binary cache
+  test17(); // Check memoized processing
+  test18(); // Check number conversion
+  test19(); // Check instrumentation
+  test20(); // Check record mode
 
   std::vector<std::vector<std::string_view>> data{
       {"0", "integer"},      // integer
@@ -53,6 +105,894 @@ void test() {
   std::println("Test completed!");
 }
 
+// --- Regex reference (the original predicates) ---
+auto rgxMatch(std::string_view value, std::string_view pattern) -> Data {
+  auto result = std::regex_match(std::string(value),
+                                 std::regex(std::string(pattern)));
+  return {result, result ? std::string(value) : ""};
+}
+
+auto rgxIsNumber(std::string_view input) -> Data {
+  if (!std::regex_search(input.begin(), input.end(), std::regex("\\d"))) {
+    return {false, ""};
+  }
+  auto str = clean(input);
+  if (str.size() >= 2) {
+    if (str.starts_with('+')) {
+      str = str.substr(1, str.length() - 1);
+    }
+    if (str.starts_with('.')) {
+      str = std::format("0{}", str);
+    }
+    if (str.at(0) == '-' && str.at(1) == '.') {
+      str = str.substr(2, str.length() - 1);
+      str = std::format("-0.{}", str);
+    }
+    if (str.ends_with('.')) {
+      str = std::format("{}0", str);
+    }
+  }
+  return rgxMatch(str, "^[+-]?(\\d+\\.?\\d*|\\d*\\.\\d+)$");
+}
+
+auto rgxIsInteger(std::string_view input) -> Data {
+  return rgxMatch(rgxIsNumber(input).value, "^-?\\d*");
+}
+
+auto rgxIsFloat(std::string_view input) -> Data {
+  return rgxMatch(rgxIsNumber(input).value, "^[+-]?\\d+\\.\\d*$");
+}
+
+auto rgxIsString(std::string_view input) -> Data {
+  return {rgxMatch(clean(input), "^'.*'$").status, std::string(input)};
+}
+
+auto rgxIsDictionary(std::string_view input) -> Data {
+  return rgxMatch(clean(input), "^\\'.+'\\s*:\\s*'?.*'?$");
+}
+
+auto rgxIsGroup(std::string_view input) -> Data {
+  return rgxMatch(clean(input), "^\\{.*\\}$");
+}
+
+// Class process() assigned to an element before the classifier existed
+auto rgxClassify(std::string_view input) -> Kind {
+  auto element = trim(input);
+  auto number = rgxIsNumber(element);
+  if (number.status) {
+    if (rgxIsInteger(number.value).status) {
+      return Kind::Integer;
+    }
+    if (rgxIsFloat(number.value).status) {
+      return Kind::Float;
+    }
+  }
+  if (rgxIsDictionary(element).status) {
+    return Kind::Dictionary;
+  }
+  if (isChar(trim(element, "'")).status) {
+    return Kind::Character;
+  }
+  if (rgxIsString(element).status) {
+    return Kind::String;
+  }
+  return Kind::Invalid;
+}
+
+void test5() {
+  auto same = [](const Data &a, const Data &b) -> bool {
+    return a.status == b.status && a.value == b.value;
+  };
+
+  auto check = [&same](std::string_view input) -> bool {
+    return same(isNumber(input), rgxIsNumber(input)) &&
+           same(isInteger(input), rgxIsInteger(input)) &&
+           same(isFloat(input), rgxIsFloat(input)) &&
+           same(isString(input), rgxIsString(input)) &&
+           same(isDictionary(input), rgxIsDictionary(input)) &&
+           same(isGroup(input), rgxIsGroup(input)) &&
+           classify(input) == rgxClassify(input);
+  };
+
+  std::vector<std::string> inputs{
+      "",         " ",          "0",           "-1",         ".5",
+      "5.",       "+.5",        "++5",         "++.5",       "++5.5",
+      "+-5",      "-+5",        "--5",         "+ 1 . 0",    "1.2.3",
+      "1e5",      "'A'",        "A",           "''",         "'''",
+      "''A''",    "'Hello'",    "' a b '",     "'a\nb'",     "'a'\n",
+      "'K1':10",  "'':10",      "'A' : 'B'",   "'a' :\n 1",  "'a': 1\n2",
+      "'a\n':1",  "'a'\t:\t'b'", "'a':'b':'c'", "{}",         "{1,2}",
+      "{\n}",     "{ }",        "}{",          "\t5\t"};
+
+  // Random strings over the alphabet that matters to the grammar
+  std::mt19937 gen(2024);
+  std::string_view alphabet = " +-.019'{}:aZ\t\n";
+  std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+  std::uniform_int_distribution<size_t> length(0, 8);
+  for (int i = 0; i < 2000; ++i) {
+    std::string s;
+    for (size_t n = length(gen); n > 0; --n) {
+      s += alphabet[pick(gen)];
+    }
+    inputs.push_back(s);
+  }
+
+  for (const auto &input : inputs) {
+    if (!check(input)) {
+      std::println("Classifier mismatch: \"{}\"", input);
+    }
+    assert(check(input));
+  }
+}
+
+void test6() {
+  clearRegexCache();
+  assert(match("123", "^\\d+$").status);
+  assert(!match("12a", "^\\d+$").status);
+  auto stats = regexCacheStats();
+  assert(stats.misses == 1 && stats.hits == 1 && stats.size == 1);
+
+  // Invalid patterns still throw and are not cached
+  try {
+    match("a", "(");
+    assert(false);
+  } catch (const std::regex_error &) {
+  }
+  assert(regexCacheStats().size == 1);
+
+  // Concurrent readers share the compiled patterns
+  {
+    std::vector<std::jthread> readers;
+    for (int t = 0; t < 4; ++t) {
+      readers.emplace_back([] {
+        for (int i = 0; i < 100; ++i) {
+          assert(match(std::to_string(i), "^\\d+$").status);
+          assert(match("'a'", "^'.*'$").status);
+        }
+      });
+    }
+  }
+  stats = regexCacheStats();
+  assert(stats.misses == 2 && stats.size == 2);
+  assert(stats.hits + stats.misses == 2 + 4 * 200);
+}
+
+void test7() {
+  std::string input = "{'K1' : 10, 'K 2' : ' a b ', 'K3' : 'Hi'}";
+  auto inside = [&input](std::string_view sv) -> bool {
+    return sv.data() >= input.data() &&
+           sv.data() + sv.size() <= input.data() + input.size();
+  };
+
+  // Dictionary keys and values point into the input
+  auto dictionary = std::get<std::vector<DictView>>(process_view(input));
+  assert(dictionary.size() == 3);
+  for (const auto &item : dictionary) {
+    assert(inside(item.key) && inside(item.value));
+  }
+  assert(dictionary[1].key == "'K 2'" && dictionary[1].value == "' a b '");
+  assert(dictionary[1].toDict().compare(Dict{"'K2'", "'ab'"}));
+
+  // Strings, including the untrimmed elements of mixed groups
+  input = "{'Hello World', 'A1'}";
+  auto strings = std::get<std::vector<std::string_view>>(process_view(input));
+  assert(strings.size() == 2 && strings[0] == "Hello World");
+  assert(std::ranges::all_of(strings, inside));
+  input = " {-1 , +2.5, 'test'} ";
+  strings = std::get<std::vector<std::string_view>>(process_view(input));
+  assert(strings.size() == 3 && strings[0] == "-1 " && strings[2] == " 'test'");
+  assert(std::ranges::all_of(strings, inside));
+
+  // Owned copies on demand give the same result as process()
+  for (std::string_view item : {"{1, 2.5}", "{'a' : '1', 'b' : 'Hi'}",
+                                "{'A', 'B'}", "{}", "x y"}) {
+    auto owned = toOwned(process_view(item));
+    assert(owned.index() == process(item).index());
+  }
+  auto owned = std::get<std::vector<Dict>>(toOwned(process_view(
+      "{'a' : '1', 'b' : 'Hi'}")));
+  assert(owned[1].compare(Dict{"'b'", "'Hi'"}));
+}
+
+void test8() {
+  // Streams the input and returns the summary and the elements as text
+  auto streamed = [](std::string_view input, size_t chunk_size) {
+    std::vector<std::string> values;
+    auto collect = [&values](std::string_view, const ElementView &value) {
+      const auto visitor = overloads{
+          [](std::string_view v) { return std::string(v); },
+          [](DictView v) {
+            auto d = v.toDict();
+            return d.key + ":" + d.value;
+          },
+          [](bool) { return std::string("?"); },
+          [](auto v) { return std::format("{}", v); },
+      };
+      values.push_back(std::visit(visitor, value));
+    };
+    std::istringstream stream{std::string(input)};
+    auto stats = process_stream(stream, collect, chunk_size);
+    return std::pair{stats, values};
+  };
+
+  using Values = std::vector<std::string>;
+  for (size_t chunk_size = 1; chunk_size < 8; ++chunk_size) {
+    auto [stats, values] = streamed("{10, -2, +3}", chunk_size);
+    assert(stats.group && stats.complete && stats.elements == 3);
+    assert((values == Values{"10", "-2", "3"}));
+
+    std::tie(stats, values) =
+        streamed("{'K1' : 10, 'K2' : 'Hi'}", chunk_size);
+    assert((values == Values{"'K1':10", "'K2':'Hi'"}));
+
+    std::tie(stats, values) = streamed("  {1,\n 2.5,\n 'A'}\n", chunk_size);
+    assert(stats.complete && (values == Values{"1", "2.5", "A"}));
+
+    std::tie(stats, values) = streamed(" 'Hello' ", chunk_size);
+    assert(!stats.group && stats.complete && (values == Values{"Hello"}));
+  }
+
+  auto [stats, values] = streamed("{}", 2);
+  assert(stats.complete && stats.elements == 0);
+  std::tie(stats, values) = streamed("{1,}", 2);
+  assert(stats.complete && stats.elements == 1);
+  std::tie(stats, values) = streamed("{1, 2", 2);
+  assert(!stats.complete && stats.elements == 1);
+  std::tie(stats, values) = streamed("", 2);
+  assert(!stats.complete && stats.elements == 0);
+
+  // Memory depends on the largest element, not on the input size
+  std::string large = "{1";
+  for (int i = 0; i < 10000; ++i) {
+    large += ", 12345";
+  }
+  large += "}";
+  std::tie(stats, values) = streamed(large, 64);
+  assert(stats.elements == 10001 && stats.peak_buffer < 64);
+
+  // Memory-mapped file
+  auto path = std::filesystem::temp_directory_path() / "test_typeParser.txt";
+  std::ofstream(path) << large;
+  size_t sum = 0;
+  auto result = process_file(path.string(),
+                             [&sum](std::string_view, const ElementView &v) {
+                               sum += std::get<int>(v);
+                             });
+  assert(std::holds_alternative<StreamStats>(result));
+  assert(std::get<StreamStats>(result).elements == 10001);
+  assert(sum == 1 + 10000 * 12345);
+  std::filesystem::remove(path);
+  assert(std::holds_alternative<bool>(process_file(path.string(), {})));
+}
+
+void test9() {
+  std::vector<std::string_view> inputs{
+      "{10,11,12}", "{0.1,1.2}",  "{1, 2.5, +3}", "{'A', 'B'}",
+      "{'a' : '1'}", " {-1 , 'x'} ", "{}",          ""};
+  for (int i = 0; i < 6; ++i) {
+    inputs.insert(inputs.end(), inputs.begin(), inputs.begin() + 8);
+  }
+
+  // Results keep the input order, whatever the pool size
+  for (size_t threads : {1, 3, 8}) {
+    auto results = process_many(inputs, threads);
+    assert(results.size() == inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      assert(results[i] == process(inputs[i]));
+    }
+  }
+
+  // A large group split across the pool gives the same result
+  ThreadPool pool(4);
+  std::string numbers = "{";
+  std::string mixed = "{";
+  for (int i = 0; i < 20000; ++i) {
+    numbers += std::format("{}{}", i ? "," : "", i % 7 ? std::to_string(i)
+                                                       : std::format("{}.5", i));
+    mixed += std::format("{}{}", i ? "," : "", i % 5 ? "'s'" : "1");
+  }
+  numbers += "}";
+  mixed += "}";
+  assert(process_parallel(numbers, pool) == process(numbers));
+  assert(process_parallel(mixed, pool) == process(mixed));
+  assert(process_parallel("{1, 2}", pool) == process("{1, 2}"));
+
+  // Nested use from inside a task does not block the pool
+  std::atomic<int> count{0};
+  pool.parallel_for(8, [&pool, &count](size_t) {
+    pool.parallel_for(8, [&count](size_t) { ++count; });
+  });
+  assert(count == 64);
+
+  // A throwing task does not stop the others, its exception reaches the caller
+  std::atomic<int> finished{0};
+  bool thrown = false;
+  try {
+    pool.parallel_for(16, [&finished](size_t i) {
+      if (i % 4 == 0) {
+        throw std::runtime_error("task failed");
+      }
+      ++finished;
+    });
+  } catch (const std::runtime_error &) {
+    thrown = true;
+  }
+  assert(thrown && finished == 12);
+}
+
+void test10() {
+  // Reference versions built on std::string_view
+  auto refSplit = [](std::string_view sv, char delimiter) {
+    std::vector<std::string_view> result;
+    size_t start = 0;
+    for (auto end = sv.find(delimiter); end != std::string_view::npos;
+         end = sv.find(delimiter, start)) {
+      result.push_back(sv.substr(start, end - start));
+      start = end + 1;
+    }
+    if (start < sv.size()) {
+      result.push_back(sv.substr(start));
+    }
+    return result;
+  };
+  auto refTrim = [](std::string_view sv) -> std::string_view {
+    auto first = sv.find_first_not_of(WHITESPACE);
+    if (first == std::string_view::npos) {
+      return {};
+    }
+    return sv.substr(first, sv.find_last_not_of(WHITESPACE) - first + 1);
+  };
+  auto refAll = [](std::string_view sv, char delimiter) {
+    std::vector<size_t> result;
+    for (size_t i = 0; i < sv.size(); ++i) {
+      if (sv[i] == delimiter) {
+        result.push_back(i);
+      }
+    }
+    return result;
+  };
+  auto refBoundaries = [refAll](std::string_view sv) {
+    std::vector<BoundaryPosition> result;
+    for (auto [delimiter, kind] :
+         {std::pair{',', Boundary::Comma}, std::pair{':', Boundary::Colon},
+          std::pair{'\'', Boundary::Quote}}) {
+      for (auto position : refAll(sv, delimiter)) {
+        result.push_back({position, kind});
+      }
+    }
+    for (size_t i = 0; i < sv.size(); ++i) {
+      if (WHITESPACE.find(sv[i]) != std::string_view::npos) {
+        result.push_back({i, Boundary::Whitespace});
+      }
+    }
+    std::ranges::sort(result, {}, &BoundaryPosition::position);
+    return result;
+  };
+
+  std::mt19937 gen(42);
+  std::string_view alphabet = " \t\n,:'ab1";
+  std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+  std::uniform_int_distribution<size_t> length(0, 100);
+  std::vector<std::string> inputs;
+  for (int i = 0; i < 2000; ++i) {
+    std::string s;
+    for (size_t n = length(gen); n > 0; --n) {
+      s += alphabet[pick(gen)];
+    }
+    inputs.push_back(s);
+  }
+  inputs.push_back(std::string(70, ' ') + "x" + std::string(70, ' '));
+
+  auto detected = detected_scan_level();
+  for (auto level : {ScanLevel::Scalar, ScanLevel::SSE2, ScanLevel::AVX2}) {
+    if (level > detected) {
+      continue;
+    }
+    assert(set_scan_level(level) == level);
+    for (std::string_view input : inputs) {
+      // Unaligned starts as well
+      for (size_t offset = 0; offset < 3 && offset <= input.size(); ++offset) {
+        auto sv = input.substr(offset);
+        assert(find_any(sv, ",:") == sv.find_first_of(",:"));
+        assert(find_any(sv, "'", 5) == sv.find_first_of("'", 5));
+        assert(find_not_any(sv, WHITESPACE) == sv.find_first_not_of(WHITESPACE));
+        assert(find_last_not_any(sv, WHITESPACE) ==
+               sv.find_last_not_of(WHITESPACE));
+        assert(find_last_not_any(sv, " ab") == sv.find_last_not_of(" ab"));
+        assert(std::ranges::equal(find_all(sv, ','), refAll(sv, ',')));
+        assert(std::ranges::equal(find_boundaries(sv), refBoundaries(sv)));
+        assert(split_view(sv, ',') == refSplit(sv, ','));
+        assert(trim_view(sv) == refTrim(sv));
+      }
+    }
+  }
+  set_scan_level(detected);
+}
+
+void test11() {
+  // The arena has no upstream: any allocation beyond it would throw
+  std::array<std::byte, 64 * 1024> buffer;
+  std::string group = "{";
+  for (int i = 0; i < 200; ++i) {
+    group += std::format("{}'K{}' : ' v {} '", i ? ", " : "", i, i);
+  }
+  group += "}";
+
+  std::vector<std::string_view> inputs{
+      "{10,11,12,13,14,15}",   "{0.1,1.2,2.3}",   "{1, 2.5, +3, 4, -5}",
+      "{'A', 'B', 'C'}",       "{'Hello', 'W'}",  " {-1 , +2.5, 'test'} ",
+      "{'a' : '1', 'b' : 'Hi'}", "{}",            "",
+      "'  some string  '",     "{1, 'A', x}",     group};
+  for (auto input : inputs) {
+    std::pmr::monotonic_buffer_resource arena(
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    auto result = process(input, &arena);
+    assert(toOwned(result) == process(input));
+  }
+
+  // Strings and keys use the resource of their vector
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                            std::pmr::null_memory_resource());
+  auto result = process(group, &arena);
+  auto &dictionary = std::get<std::pmr::vector<PmrDict>>(result);
+  assert(dictionary.size() == 200);
+  assert(dictionary[7].key == "'K7'" && dictionary[7].value == "'v7'");
+  assert(dictionary[7].value.get_allocator().resource() == &arena);
+}
+
+void test12() {
+  // Single-pass inference against the buckets collected for every element
+  std::vector<std::string_view> pieces{"1",     "-2",   "2.5",  "+3",  "-0.5",
+                                       "'A'",   "'Hi'", "'k':'v'", "x", "7"};
+  std::mt19937 rng(12);
+  std::uniform_int_distribution<size_t> pick(0, pieces.size() - 1);
+  std::uniform_int_distribution<size_t> length(1, 8);
+  for (int n = 0; n < 2000; ++n) {
+    std::string group = "{";
+    for (size_t i = 0, count = length(rng); i < count; ++i) {
+      group += std::format("{}{}", i ? ", " : "", pieces[pick(rng)]);
+    }
+    group += "}";
+
+    auto elements = group_elements(group);
+    ElementBuckets buckets;
+    for (auto e : elements) {
+      buckets.add(process_element(e));
+    }
+    assert(toOwned(process_view(group)) ==
+           toOwned(select(std::move(buckets), elements)));
+  }
+
+  // Integers stay before floats, whatever the order of the input
+  auto numbers = std::get<std::vector<float>>(process("{0.5, 1, 1.5, 2, 3}"));
+  assert((numbers == std::vector<float>{1, 2, 3, 0.5f, 1.5f}));
+}
+
+// Compares a compile-time result with process()
+template <class T, size_t N>
+auto sameAsProcess(const std::array<T, N> &literal, std::string_view input)
+    -> bool {
+  auto owned = [](const T &item) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      return std::string(item);
+    } else if constexpr (std::is_same_v<T, DictView>) {
+      return item.toDict();
+    } else {
+      return item;
+    }
+  };
+  using Owned = decltype(owned(literal[0]));
+  std::vector<Owned> expected;
+  for (const auto &item : literal) {
+    expected.push_back(owned(item));
+  }
+  return process(input) == ParsedData(expected);
+}
+
+void test13() {
+  // Parsed while compiling
+  constexpr auto integers = parse_literal<"{1, -2, +3}">();
+  static_assert(integers == std::array{1, -2, 3});
+  constexpr auto numbers = parse_literal<"{0.5, 1, 2.25, 3}">();
+  static_assert(numbers == std::array{1.0f, 3.0f, 0.5f, 2.25f});
+  static_assert(parse_literal<"{'A', 'B'}">() == std::array{'A', 'B'});
+  static_assert(parse_literal<"{2.0, 4.50}">() == std::array{2.0f, 4.5f});
+  static_assert(parse_literal<"{++5, -.5}">() == std::array{5.0f, -0.5f});
+  static_assert(parse_literal<"{}">() == true);
+  constexpr auto dictionary = parse_literal<"{'a' : 1, 'b' : 'Hi'}">();
+  static_assert(dictionary[1].key == "'b'" && dictionary[1].value == "'Hi'");
+
+  // Same results as the runtime parser
+  assert(sameAsProcess(integers, "{1, -2, +3}"));
+  assert(sameAsProcess(numbers, "{0.5, 1, 2.25, 3}"));
+  assert(sameAsProcess(parse_literal<"{2.0, 4.0}">(), "{2.0, 4.0}"));
+  assert(sameAsProcess(parse_literal<"{-0.1, 3.14159, .5}">(),
+                       "{-0.1, 3.14159, .5}"));
+  assert(sameAsProcess(parse_literal<"{'Hello', 'W'}">(), "{'Hello', 'W'}"));
+  assert(sameAsProcess(parse_literal<" {-1 , +2.5, 'test'} ">(),
+                       " {-1 , +2.5, 'test'} "));
+  assert(sameAsProcess(dictionary, "{'a' : 1, 'b' : 'Hi'}"));
+  assert(sameAsProcess(parse_literal<"'  some string  '">(),
+                       "'  some string  '"));
+  assert(sameAsProcess(parse_literal<"{2147483647, -2147483648}">(),
+                       "{2147483647, -2147483648}"));
+
+  // The shared conversions, called at runtime, against from_chars
+  std::mt19937 rng(13);
+  std::uniform_int_distribution<int> digits(0, 9999999);
+  std::uniform_int_distribution<int> dot(0, 7);
+  for (int n = 0; n < 20000; ++n) {
+    auto text = std::to_string(digits(rng));
+    text.insert(text.size() - std::min<size_t>(dot(rng), text.size()), ".");
+    text = (n % 2 ? "-" : "") + text;
+    assert(detail::literalElement(text) == process_element(text));
+  }
+
+  // Up to 19 significant digits, where rounding through double would differ
+  std::uniform_int_distribution<unsigned long long> wide(
+      0, 9999999999999999999ull);
+  std::uniform_int_distribution<int> scale(0, 25);
+  for (int n = 0; n < 20000; ++n) {
+    auto text = std::to_string(wide(rng) >> (n % 40));
+    auto decimals = static_cast<size_t>(scale(rng));
+    if (text.size() <= decimals) {
+      text.insert(0, decimals - text.size() + 1, '0');
+    }
+    text.insert(text.size() - decimals, ".");
+    assert(detail::literalElement(text) == process_element(text));
+  }
+  static_assert(parse_literal<"{0.1, 16777217.5, 0.30000001192092896}">() ==
+                std::array{16777218.0f, 0.1f, 0.3f}); // whole values first
+}
+
+void test14() {
+  // Nested groups, typed values and quoted delimiters
+  std::string_view input = "{'a' : {1, 2.5}, 'b, c' : 'x: y', 'n' : -3, {'A'}}";
+  auto parsed = parse_tree(input);
+  assert(std::holds_alternative<ParseTree>(parsed));
+  const auto &tree = std::get<ParseTree>(parsed);
+  const auto &root = tree.root();
+  assert(root.type == NodeType::Group && root.size == 4);
+  assert(root.end == tree.nodes().size());
+
+  std::vector<const Node *> children;
+  for (const auto &child : tree.children(root)) {
+    children.push_back(&child);
+  }
+  assert(children.size() == 4);
+  assert(children[0]->type == NodeType::Pair);
+  assert(std::get<std::string_view>(children[0]->value) == "'a'");
+  const auto &inner = *tree.children(*children[0]).begin();
+  assert(inner.type == NodeType::Group && inner.size == 2);
+  assert(std::get<std::string_view>(children[1]->value) == "'b, c'");
+  const auto &text = *tree.children(*children[1]).begin();
+  assert(text.type == NodeType::String &&
+         std::get<std::string_view>(text.value) == "x: y");
+  assert(std::get<int>(tree.children(*children[2]).begin()->value) == -3);
+  assert(children[3]->type == NodeType::Group);
+
+  assert(toString(tree) == input);
+
+  // Flat groups give the same values as process()
+  assert(toString(std::get<ParseTree>(parse_tree(" {1 , 2, +3} "))) ==
+         "{1, 2, 3}");
+  assert(toString(std::get<ParseTree>(parse_tree("'  some string  '"))) ==
+         "'  some string  '");
+  assert(toString(std::get<ParseTree>(parse_tree("{}"))) == "{}");
+
+  // Unable to parse
+  for (auto input : {"", "{1, 2", "{1,, 2}", "{1} 2", "{x y z}", "{'a' : }",
+                     "{1 : 2}", "{'a\n'}"}) {
+    assert(std::holds_alternative<bool>(parse_tree(input)));
+  }
+  std::string deep(1000, '{');
+  deep += std::string(1000, '}');
+  assert(std::holds_alternative<bool>(parse_tree(deep)));
+}
+
+void test15() {
+  std::string group = "{";
+  for (int i = 0; i < 1000; ++i) {
+    group += std::format("{}'K {}' : ' v {} '", i ? ", " : "", i, i);
+  }
+  group += ", 'K 7' : 'again'}";
+
+  // Same entries as process()
+  auto parsed = process_columns(group);
+  assert(std::holds_alternative<DictColumns>(parsed));
+  const auto &columns = std::get<DictColumns>(parsed);
+  auto expected = std::get<std::vector<Dict>>(process(group));
+  assert(columns.size() == 1001);
+  assert(columns.toDicts() == expected);
+  assert(toColumns(expected) == columns);
+  assert(columns.keys()[3] == "'K3'" && columns.values()[3] == "'v3'");
+
+  // Lookups, the first entry wins for a duplicate key
+  assert(columns.find("'K7'") == 7);
+  assert(columns.value(columns.find("'K999'")) == "'v999'");
+  assert(columns.find("'K1000'") == DictColumns::npos);
+  assert(columns.find("K7") == DictColumns::npos);
+
+  // The index is rebuilt after an append, and built once for all threads
+  auto copy = columns;
+  copy.push_back("'extra'", "1");
+  assert(copy.find("'extra'") == 1001);
+  assert(columns.find("'extra'") == DictColumns::npos);
+  DictColumns shared = toColumns(expected);
+  std::vector<std::jthread> threads;
+  std::atomic<bool> ok{true};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&shared, &ok, t] {
+      for (int i = t; i < 1000; i += 4) {
+        if (shared.find(std::format("'K{}'", i)) != static_cast<size_t>(i)) {
+          ok = false;
+        }
+      }
+    });
+  }
+  threads.clear();
+  assert(ok);
+
+  assert(std::get<bool>(process_columns("{}")));
+  assert(!std::get<bool>(process_columns("{'a' : 1, 2}")));
+  assert(!std::get<bool>(process_columns("")));
+}
+
+void test16() {
+  std::vector<std::string_view> inputs{
+      "{10,11,12,13,14,15}",   "{0.1,1.2,2.3}",   "{1, 2.5, +3, 4, -5}",
+      "{'A', 'B', 'C'}",       "{'Hello', 'W'}",  " {-1 , +2.5, 'test'} ",
+      "{'a' : '1', 'b' : 'Hi'}", "{}",            "",
+      "{'' , 'x'}",            "{'k' : ''}"};
+  std::vector<ParsedData> results;
+  for (auto input : inputs) {
+    results.push_back(process(input));
+  }
+
+  auto path = std::filesystem::temp_directory_path() / "test_typeParser.bin";
+  assert(write_cache(path.string(), results));
+  {
+    auto opened = ParsedCache::open(path.string());
+    assert(std::holds_alternative<ParsedCache>(opened));
+    auto cache = std::move(std::get<ParsedCache>(opened));
+    assert(cache.size() == results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      assert(cache[i] && toOwned(*cache[i]) == results[i]);
+    }
+    assert(cache[results.size()].error() == CacheError::OutOfRange);
+
+    // Read in place
+    auto strings = std::get<StringColumnView>(*cache[4]);
+    assert(strings.size() == 2 && strings[0] == "'Hello'");
+    auto dictionary = std::get<DictColumnsView>(*cache[6]);
+    assert(dictionary.keys[1] == "'b'" && dictionary.values[1] == "'Hi'");
+    assert(std::get<std::span<const int>>(*cache[0])[5] == 15);
+  }
+
+  // Damaged files are refused, or their records reported as damaged
+  auto bytes = serialize(results);
+  auto check = [&path](std::string_view content) {
+    std::ofstream(path, std::ios::binary)
+        .write(content.data(), static_cast<std::streamsize>(content.size()));
+    auto opened = ParsedCache::open(path.string());
+    if (auto *cache = std::get_if<ParsedCache>(&opened)) {
+      for (size_t i = 0; i < cache->size(); ++i) {
+        if (auto record = (*cache)[i]) {
+          (void)toOwned(*record);
+        } else {
+          assert(record.error() == CacheError::Damaged);
+        }
+      }
+      return true;
+    }
+    return false;
+  };
+  assert(!check(std::string_view(bytes).substr(0, bytes.size() / 2)));
+  assert(!check("not a cache file at all, really"));
+  std::mt19937 rng(16);
+  for (int n = 0; n < 200; ++n) {
+    auto damaged = bytes;
+    damaged[std::uniform_int_distribution<size_t>(0, bytes.size() - 1)(rng)] ^=
+        static_cast<char>(1 << (n % 8));
+    check(damaged);
+  }
+
+  // An unknown record type is an error, a cached "unable to parse" a value
+  auto retyped = bytes;
+  retyped[sizeof(uint64_t) * (results.size() + 4)] = 9; // type of record 0
+  std::ofstream(path, std::ios::binary)
+      .write(retyped.data(), static_cast<std::streamsize>(retyped.size()));
+  {
+    auto opened = ParsedCache::open(path.string());
+    auto &cache = std::get<ParsedCache>(opened);
+    assert(cache[0].error() == CacheError::Damaged);
+    assert(cache[8] && std::get<bool>(*cache[8]) == false);
+  }
+  std::filesystem::remove(path);
+  assert(std::holds_alternative<bool>(ParsedCache::open(path.string())));
+}
+
+void test17() {
+  ProcessCache cache(4);
+  auto first = cache.process("{'K1' : 10, 'K2' : -2.5}");
+  assert(*first == process("{'K1' : 10, 'K2' : -2.5}"));
+  // Same entry, surrounding whitespace ignored
+  assert(cache.process("  {'K1' : 10, 'K2' : -2.5}\n") == first);
+  auto stats = cache.stats();
+  assert(stats.hits == 1 && stats.misses == 1 && stats.size == 1);
+  assert(stats.hit_rate() == 0.5);
+
+  // Bounded: the least recently used entries go first
+  for (int i = 0; i < 100; ++i) {
+    assert(*cache.process(std::format("{{{}}}", i)) ==
+           process(std::format("{{{}}}", i)));
+  }
+  stats = cache.stats();
+  assert(stats.size <= stats.capacity && stats.capacity == 4);
+  assert(stats.evictions == 101 - stats.size);
+  assert(*first == process("{'K1' : 10, 'K2' : -2.5}")); // Still usable
+
+  // Concurrent callers
+  cache.clear();
+  std::vector<std::jthread> threads;
+  std::atomic<bool> ok{true};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, &ok] {
+      for (int i = 0; i < 2000; ++i) {
+        auto input = std::format("{{{}, {}.5}}", i % 8, i % 8);
+        if (*cache.process(input) != process(input)) {
+          ok = false;
+        }
+      }
+    });
+  }
+  threads.clear();
+  assert(ok);
+  stats = cache.stats();
+  assert(stats.hits + stats.misses == 8000);
+}
+
+void test18() {
+  // Grammar of isNumber, read without building strings
+  float real = 0;
+  assert(parseNumber("+.5", real) && real == 0.5f);
+  assert(parseNumber("-.5", real) && real == -0.5f);
+  assert(parseNumber("5.", real) && real == 5.0f);
+  assert(parseNumber(" - 1 2 . 5 ", real) && real == -12.5f);
+  assert(parseNumber("++5.5", real) && real == 5.5f);
+  assert(!parseNumber("1.2.3", real) && !parseNumber("--5", real));
+  int integer = 0;
+  assert(parseNumber("-2147483648", integer) && integer == -2147483647 - 1);
+  assert(!parseNumber("2147483648", integer) && !parseNumber("1.5", integer));
+
+  // Whole values only become int inside the int range
+  assert(std::get<int>(stringviewToNumber<float>("2.0")) == 2);
+  assert(std::get<float>(stringviewToNumber<double>("3000000000.0")) == 3e9f);
+
+  // 64-bit mode: nothing narrowed, out of range fails
+  assert(std::get<int64_t>(stringviewToNumber64("-9223372036854775808")) ==
+         std::numeric_limits<int64_t>::min());
+  assert(std::get<int64_t>(stringviewToNumber64("+3000000000")) ==
+         3000000000);
+  assert(std::get<bool>(stringviewToNumber64("9223372036854775808")) == false);
+  assert(std::get<double>(stringviewToNumber64("0.1")) == 0.1);
+  assert(std::get<double>(stringviewToNumber64("2.")) == 2.0);
+  assert(std::get<bool>(stringviewToNumber64("'5'")) == false);
+
+  // Same values as converting the normalized text of isNumber
+  std::mt19937 rng(18);
+  std::string_view alphabet = " +-.0123456789";
+  std::uniform_int_distribution<size_t> length(1, 12);
+  std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+  for (int n = 0; n < 20000; ++n) {
+    std::string text;
+    for (size_t i = 0, count = length(rng); i < count; ++i) {
+      text += alphabet[pick(rng)];
+    }
+    auto number = isNumber(isNumber(text).value);
+    double expected = 0;
+    double value = 0;
+    auto &s = number.value;
+    bool parsed =
+        number.status &&
+        std::from_chars(s.data(), s.data() + s.size(), expected).ptr ==
+            s.data() + s.size();
+    assert(parseNumber(text, value) == parsed);
+    assert(!parsed || value == expected);
+  }
+}
+
+void test19() {
+  std::vector<ParseReport> reports;
+  set_report_sink(
+      [&reports](const ParseReport &report) { reports.push_back(report); });
+  auto input = std::string_view("{10, 'Hello', 2.5, 'A'}");
+  auto result = process(input);
+  set_report_sink({});
+  process(input); // Not reported
+  assert(result == process(input));
+
+  if constexpr (instrumentation_enabled) {
+    // process() calls process_view(): reported once, as the outer call
+    assert(reports.size() == 1);
+    auto &report = reports.front();
+    assert(report.function == "process");
+    assert(report.bytes == input.size() && report.elements == 4);
+    assert(report.allocations > 0 && report.allocated_bytes > 0);
+    assert(report.stage(Stage::Split).count() > 0);
+    assert(report.stage(Stage::Convert).count() > 0);
+    assert(report.total >= report.stage(Stage::Split));
+  } else {
+    assert(reports.empty());
+  }
+
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 100; ++i) {
+    histogram.add(std::chrono::nanoseconds(i == 100 ? 5000 : 100));
+  }
+  assert(histogram.count() == 100);
+  assert(histogram.percentile(0.5) == std::chrono::nanoseconds(128));
+  assert(histogram.percentile(1.0) == std::chrono::nanoseconds(8192));
+}
+
+void test20() {
+  // Several chunks, blank lines, CRLF and no final line break
+  std::string text;
+  std::vector<std::string> lines;
+  for (int i = 0; i < 40000; ++i) {
+    switch (i % 5) {
+    case 0:
+      lines.push_back(std::format("{{{}, {}}}", i, -i));
+      break;
+    case 1:
+      lines.push_back(std::format("{{'K{}' : {}.5}}\r", i, i));
+      break;
+    case 2:
+      lines.push_back(i % 7 == 2 ? "{1, 'A'" : "{}");
+      break;
+    case 3:
+      lines.push_back("   ");
+      break;
+    default:
+      lines.push_back(std::format("'S{}'", i));
+      break;
+    }
+    text += lines.back();
+    text += i + 1 < 40000 ? "\n" : "";
+  }
+
+  ThreadPool pool(3);
+  size_t expected_line = 0;
+  std::atomic<bool> ok{true};
+  auto check = [&](size_t line, const ParsedData &record) {
+    auto input = trim_view(lines[line - 1]);
+    if (line <= expected_line || input.empty() || record != process(input)) {
+      ok = false;
+    }
+    expected_line = line;
+  };
+  auto stats = process_records(text, check, pool);
+  assert(ok && expected_line == 40000);
+  assert(stats.records == 32000 && stats.blank == 8000);
+  assert(stats.bytes == text.size());
+  assert(stats.types[0] == 8000 && stats.types[3] == 8000);
+  assert(stats.types[4] == 8000);
+  assert(stats.failed == 1143 && stats.types[5] == 8000 - 1143);
+  assert(stats.failures.size() == RecordStats::max_failures);
+  assert(stats.failures.front().line == 3 &&
+         stats.failures.front().text == "{1, 'A'");
+
+  // Same records from a mapped file
+  auto path = std::filesystem::temp_directory_path() / "typeRecords.txt";
+  std::ofstream(path, std::ios::binary) << text;
+  expected_line = 0;
+  auto result = process_record_file(path.string(), check, pool);
+  std::filesystem::remove(path);
+  assert(ok && std::get<RecordStats>(result).records == stats.records);
+  assert(std::get<bool>(process_record_file("missing.txt", check, pool)) ==
+         false);
+}
+
 void test4(std::vector<std::vector<std::string_view>> vec) {
 
   auto typeOf =
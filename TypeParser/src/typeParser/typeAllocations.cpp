@@ -0,0 +1,23 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Counting replacement of the global operator new for thread_allocations().
+ * Not part of the library: only the executables built with it have every
+ * allocation of the program counted.
+ */
+
+#include "typeInstrument.hpp"
+
+#include <cstdlib>
+#include <new>
+
+auto operator new(std::size_t size) -> void * {
+  count_allocation(size);
+  if (auto *p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
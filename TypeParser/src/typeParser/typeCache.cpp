@@ -0,0 +1,347 @@
+#include "typeCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char magic[8] = "TPCACHE";
+constexpr uint32_t version = 1;
+constexpr uint32_t byte_order = 0x01020304;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t count;
+};
+
+struct RecordHeader {
+  uint32_t type;
+  uint32_t flag;
+  uint64_t count;
+};
+
+// --- Writing ---
+
+template <class T> void put(std::string &out, const T &value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+void putAll(std::string &out, const std::vector<T> &values) {
+  out.append(reinterpret_cast<const char *>(values.data()),
+             values.size() * sizeof(T));
+}
+
+void align(std::string &out) { out.resize((out.size() + 7) & ~size_t{7}); }
+
+// Offsets of a string column, followed by 'bytes' in the record
+template <class Strings, class Get>
+void putOffsets(std::string &out, const Strings &strings, Get get) {
+  uint64_t offset = 0;
+  put(out, uint32_t{0});
+  for (const auto &item : strings) {
+    offset += get(item).size();
+    if (offset > std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error("serialize: strings larger than 4 GiB");
+    }
+    put(out, static_cast<uint32_t>(offset));
+  }
+}
+
+template <class Strings, class Get>
+void putBytes(std::string &out, const Strings &strings, Get get) {
+  for (const auto &item : strings) {
+    out += get(item);
+  }
+}
+
+void putRecord(std::string &out, const ParsedData &data) {
+  auto header = [&out, &data](uint64_t count, uint32_t flag = 0) {
+    put(out, RecordHeader{static_cast<uint32_t>(data.index()), flag, count});
+  };
+  auto self = [](const std::string &s) -> const std::string & { return s; };
+  auto key = [](const Dict &d) -> const std::string & { return d.key; };
+  auto value = [](const Dict &d) -> const std::string & { return d.value; };
+
+  const auto visitor = overloads{
+      [&](const std::vector<std::string> &vec) {
+        header(vec.size());
+        putOffsets(out, vec, self);
+        putBytes(out, vec, self);
+      },
+      [&](const std::vector<Dict> &vec) {
+        header(vec.size());
+        putOffsets(out, vec, key);
+        putOffsets(out, vec, value);
+        putBytes(out, vec, key);
+        putBytes(out, vec, value);
+      },
+      [&](bool v) { header(0, v); },
+      [&](const auto &vec) {
+        header(vec.size());
+        putAll(out, vec);
+      },
+  };
+  std::visit(visitor, data);
+  align(out);
+}
+
+// --- Reading ---
+
+template <class T> auto get(const std::byte *data, size_t offset) -> T {
+  T value;
+  std::memcpy(&value, data + offset, sizeof(T));
+  return value;
+}
+
+// Array of 'count' T at 'offset' of the record [begin, end), or empty
+template <class T>
+auto arrayAt(const std::byte *data, size_t offset, size_t count, size_t end)
+    -> std::span<const T> {
+  if (count > (end - offset) / sizeof(T)) {
+    return {};
+  }
+  return {reinterpret_cast<const T *>(data + offset), count};
+}
+
+} // namespace
+
+auto serialize(std::span<const ParsedData> data) -> std::string {
+  std::string out;
+  Header header{};
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.byteOrder = byte_order;
+  header.count = data.size();
+  put(out, header);
+
+  // Table filled once the records are written
+  auto table = out.size();
+  out.resize(table + (data.size() + 1) * sizeof(uint64_t));
+  for (size_t i = 0; i < data.size(); ++i) {
+    uint64_t offset = out.size();
+    std::memcpy(out.data() + table + i * sizeof(uint64_t), &offset,
+                sizeof(offset));
+    putRecord(out, data[i]);
+  }
+  uint64_t end = out.size();
+  std::memcpy(out.data() + table + data.size() * sizeof(uint64_t), &end,
+              sizeof(end));
+  return out;
+}
+
+auto write_cache(const std::string &path, std::span<const ParsedData> data)
+    -> bool {
+  auto bytes = serialize(data);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  return static_cast<bool>(file.flush());
+}
+
+auto toOwned(const CachedData &data) -> ParsedData {
+  auto strings = [](const StringColumnView &column) {
+    std::vector<std::string> vec;
+    vec.reserve(column.size());
+    for (size_t i = 0; i < column.size(); ++i) {
+      vec.emplace_back(column[i]);
+    }
+    return vec;
+  };
+  const auto visitor = overloads{
+      [&](const StringColumnView &column) -> ParsedData {
+        return strings(column);
+      },
+      [](const DictColumnsView &columns) -> ParsedData {
+        std::vector<Dict> vec;
+        vec.reserve(columns.size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+          vec.push_back(
+              {std::string(columns.keys[i]), std::string(columns.values[i])});
+        }
+        return vec;
+      },
+      [](bool v) -> ParsedData { return v; },
+      []<class T>(std::span<const T> values) -> ParsedData {
+        return std::vector<T>(values.begin(), values.end());
+      },
+  };
+  return std::visit(visitor, data);
+}
+
+auto ParsedCache::open(const std::string &path)
+    -> std::variant<ParsedCache, bool> {
+  ParsedCache cache;
+#ifdef _MSC_VER
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  file.seekg(0, std::ios::end);
+  cache.buffer.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  file.read(reinterpret_cast<char *>(cache.buffer.data()),
+            static_cast<std::streamsize>(cache.buffer.size()));
+  cache.data = cache.buffer.data();
+  cache.length = cache.buffer.size();
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || info.st_size < 0) {
+    ::close(fd);
+    return false;
+  }
+  cache.length = static_cast<size_t>(info.st_size);
+  if (cache.length >= sizeof(Header)) {
+    void *map = ::mmap(nullptr, cache.length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED) {
+      cache.data = static_cast<const std::byte *>(map);
+      cache.mapped = true;
+    }
+  }
+  ::close(fd);
+  if (!cache.mapped) {
+    return false;
+  }
+#endif
+
+  // Only the header and the table are checked here, records when read
+  if (cache.length < sizeof(Header)) {
+    return false;
+  }
+  auto header = get<Header>(cache.data, 0);
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+      header.version != version || header.byteOrder != byte_order ||
+      header.count >= (cache.length - sizeof(Header)) / sizeof(uint64_t)) {
+    return false;
+  }
+  cache.count = header.count;
+  uint64_t previous = sizeof(Header) + (cache.count + 1) * sizeof(uint64_t);
+  for (size_t i = 0; i <= cache.count; ++i) {
+    auto offset = get<uint64_t>(cache.data, sizeof(Header) + i * 8);
+    if (offset < previous || offset > cache.length || offset % 8 != 0) {
+      return false;
+    }
+    previous = offset;
+  }
+  return cache;
+}
+
+ParsedCache::ParsedCache(ParsedCache &&other) noexcept {
+  *this = std::move(other);
+}
+
+auto ParsedCache::operator=(ParsedCache &&other) noexcept -> ParsedCache & {
+  if (this != &other) {
+    release();
+    data = std::exchange(other.data, nullptr);
+    length = std::exchange(other.length, 0);
+    count = std::exchange(other.count, 0);
+    mapped = std::exchange(other.mapped, false);
+    buffer = std::move(other.buffer);
+  }
+  return *this;
+}
+
+ParsedCache::~ParsedCache() { release(); }
+
+void ParsedCache::release() {
+#ifndef _MSC_VER
+  if (mapped) {
+    ::munmap(const_cast<std::byte *>(data), length);
+  }
+#endif
+  data = nullptr;
+  mapped = false;
+}
+
+auto ParsedCache::operator[](size_t index) const
+    -> std::expected<CachedData, CacheError> {
+  if (index >= count) {
+    return std::unexpected(CacheError::OutOfRange);
+  }
+  auto table = sizeof(Header) + index * sizeof(uint64_t);
+  auto begin = static_cast<size_t>(get<uint64_t>(data, table));
+  auto end = static_cast<size_t>(get<uint64_t>(data, table + 8));
+  if (end - begin < sizeof(RecordHeader)) {
+    return std::unexpected(CacheError::Damaged);
+  }
+  auto record = get<RecordHeader>(data, begin);
+  auto payload = begin + sizeof(RecordHeader);
+  auto count = static_cast<size_t>(record.count);
+
+  // String column at 'offset', its bytes at 'bytes' (both advanced)
+  auto column = [&](size_t &offset, size_t &bytes) -> StringColumnView {
+    if (count == std::numeric_limits<size_t>::max()) {
+      return {};
+    }
+    auto offsets = arrayAt<uint32_t>(data, offset, count + 1, end);
+    if (offsets.empty() || offsets.front() != 0 || bytes > end ||
+        offsets.back() > end - bytes ||
+        !std::ranges::is_sorted(offsets)) {
+      return {};
+    }
+    StringColumnView view{
+        offsets, {reinterpret_cast<const char *>(data + bytes), offsets.back()}};
+    offset += offsets.size_bytes();
+    bytes += offsets.back();
+    return view;
+  };
+
+  switch (record.type) {
+  case 0:
+    if (auto values = arrayAt<int>(data, payload, count, end);
+        values.size() == count) {
+      return values;
+    }
+    break;
+  case 1:
+    if (auto values = arrayAt<float>(data, payload, count, end);
+        values.size() == count) {
+      return values;
+    }
+    break;
+  case 2:
+    if (auto values = arrayAt<char>(data, payload, count, end);
+        values.size() == count) {
+      return values;
+    }
+    break;
+  case 3: {
+    auto offset = payload;
+    auto bytes = payload + (count + 1) * sizeof(uint32_t);
+    if (auto strings = column(offset, bytes); strings.size() == count) {
+      return strings;
+    }
+    break;
+  }
+  case 4: {
+    auto offset = payload;
+    auto bytes = payload + 2 * (count + 1) * sizeof(uint32_t);
+    auto keys = column(offset, bytes);
+    auto values = column(offset, bytes);
+    if (keys.size() == count && values.size() == count) {
+      return DictColumnsView{keys, values};
+    }
+    break;
+  }
+  case 5:
+    return record.flag != 0;
+  }
+  return std::unexpected(CacheError::Damaged);
+}
@@ -0,0 +1,96 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Binary cache of parsed results. The file is mapped into memory and read in
+ * place: numbers are returned as spans and strings as offset columns pointing
+ * into the mapping, nothing is decoded or copied.
+ *
+ * Layout (host byte order, every record aligned to 8 bytes):
+ *   header  magic "TPCACHE", version, byte order mark, record count
+ *   table   uint64 offset of each record, then the end of the last one
+ *   record  uint32 type (ParsedData index), uint32 bool value, uint64 count,
+ *           then int32 / float / char values, or uint32 offsets (count + 1)
+ *           and the bytes of the strings (keys then values for dictionaries)
+ */
+#pragma once
+
+#include "typeParser.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+
+// Strings of a cached record: entry i is bytes[offsets[i], offsets[i + 1])
+struct StringColumnView {
+  std::span<const uint32_t> offsets;
+  std::string_view bytes;
+
+  auto size() const -> size_t {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+
+  auto operator[](size_t index) const -> std::string_view {
+    return bytes.substr(offsets[index], offsets[index + 1] - offsets[index]);
+  }
+};
+
+struct DictColumnsView {
+  StringColumnView keys;
+  StringColumnView values;
+
+  auto size() const -> size_t { return keys.size(); }
+};
+
+// Same shape as ParsedData, pointing into the cache
+using CachedData =
+    std::variant<std::span<const int>, std::span<const float>,
+                 std::span<const char>, StringColumnView, DictColumnsView,
+                 bool>;
+
+// Why a cached result could not be read
+enum class CacheError {
+  OutOfRange, // index not below size()
+  Damaged     // record inconsistent with its header or the file
+};
+
+// Function encodes the results (throws std::length_error when the strings of
+// one result exceed 4 GiB)
+auto serialize(std::span<const ParsedData> data) -> std::string;
+
+// Function writes the encoded results to a file (false on failure)
+auto write_cache(const std::string &path, std::span<const ParsedData> data)
+    -> bool;
+
+// Function copies a cached result
+auto toOwned(const CachedData &data) -> ParsedData;
+
+class ParsedCache {
+public:
+  // Function maps a cache file (false when missing or not a valid cache)
+  static auto open(const std::string &path) -> std::variant<ParsedCache, bool>;
+
+  ParsedCache(ParsedCache &&other) noexcept;
+  auto operator=(ParsedCache &&other) noexcept -> ParsedCache &;
+  ParsedCache(const ParsedCache &) = delete;
+  auto operator=(const ParsedCache &) -> ParsedCache & = delete;
+  ~ParsedCache();
+
+  auto size() const -> size_t { return count; }
+
+  // Result 'index', valid while the cache is open. The index, the record
+  // bounds and the string offsets are checked on each access; a cached
+  // "unable to parse" result is the value false, not an error.
+  auto operator[](size_t index) const -> std::expected<CachedData, CacheError>;
+
+private:
+  ParsedCache() = default;
+
+  void release();
+
+  const std::byte *data = nullptr;
+  size_t length = 0;
+  size_t count = 0;
+  bool mapped = false;
+  std::vector<std::byte> buffer; // Without mmap, the file read into memory
+};
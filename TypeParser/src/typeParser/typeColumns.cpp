@@ -0,0 +1,186 @@
+#include "typeColumns.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+// Open addressing, linear probing. Each slot keeps the hash next to the row,
+// so a probe only reads the key bytes when the hashes are equal.
+struct DictColumns::Index {
+  struct Slot {
+    uint32_t hash = 0;
+    uint32_t row = 0; // row + 1, 0 when empty
+  };
+
+  std::vector<Slot> slots;
+  size_t mask = 0;
+};
+
+namespace {
+
+auto hashKey(std::string_view key) -> uint32_t {
+  auto hash = std::hash<std::string_view>{}(key);
+  return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+// Size of 'bytes' once 'text' is appended without its spaces
+auto cleanEnd(const std::string &bytes, std::string_view text) -> size_t {
+  auto end = bytes.size() + text.size() - std::ranges::count(text, ' ');
+  if (end > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("DictColumns: column larger than 4 GiB");
+  }
+  return end;
+}
+
+// Appends 'text' without its spaces, returns the end offset
+auto appendClean(std::string &bytes, std::string_view text) -> uint32_t {
+  std::ranges::copy_if(text, std::back_inserter(bytes),
+                       [](char c) { return c != ' '; });
+  return static_cast<uint32_t>(bytes.size());
+}
+
+} // namespace
+
+DictColumns::DictColumns(const DictColumns &other)
+    : keyColumn(other.keyColumn), valueColumn(other.valueColumn),
+      lookup(other.lookup.load()) {}
+
+DictColumns::DictColumns(DictColumns &&other) noexcept
+    : keyColumn(std::move(other.keyColumn)),
+      valueColumn(std::move(other.valueColumn)),
+      lookup(other.lookup.exchange({})) {}
+
+auto DictColumns::operator=(const DictColumns &other) -> DictColumns & {
+  if (this != &other) {
+    keyColumn = other.keyColumn;
+    valueColumn = other.valueColumn;
+    lookup = other.lookup.load();
+  }
+  return *this;
+}
+
+auto DictColumns::operator=(DictColumns &&other) noexcept -> DictColumns & {
+  keyColumn = std::move(other.keyColumn);
+  valueColumn = std::move(other.valueColumn);
+  lookup = other.lookup.exchange({});
+  return *this;
+}
+
+void DictColumns::reserve(size_t entries, size_t bytes) {
+  keyColumn.offsets.reserve(entries + 1);
+  valueColumn.offsets.reserve(entries + 1);
+  keyColumn.bytes.reserve(bytes);
+  valueColumn.bytes.reserve(bytes);
+}
+
+void DictColumns::push_back(std::string_view key, std::string_view value) {
+  // Both checked first: either the entry is added or nothing changes
+  cleanEnd(keyColumn.bytes, key);
+  cleanEnd(valueColumn.bytes, value);
+
+  auto keySize = keyColumn.bytes.size();
+  auto valueSize = valueColumn.bytes.size();
+  auto rows = keyColumn.offsets.size();
+  try {
+    keyColumn.offsets.push_back(appendClean(keyColumn.bytes, key));
+    valueColumn.offsets.push_back(appendClean(valueColumn.bytes, value));
+  } catch (...) { // Out of memory
+    keyColumn.bytes.resize(keySize);
+    valueColumn.bytes.resize(valueSize);
+    keyColumn.offsets.resize(rows);
+    throw;
+  }
+  lookup.store({}); // Rebuilt by the next find
+}
+
+auto DictColumns::index() const -> std::shared_ptr<const Index> {
+  if (auto built = lookup.load()) {
+    return built;
+  }
+
+  // Built outside any lock: concurrent first calls may build it twice
+  auto built = std::make_shared<Index>();
+  auto capacity = std::bit_ceil(std::max<size_t>(size() * 2, 8));
+  built->slots.resize(capacity);
+  built->mask = capacity - 1;
+  for (size_t row = 0; row < size(); ++row) {
+    auto hash = hashKey(key(row));
+    for (auto i = hash & built->mask;; i = (i + 1) & built->mask) {
+      auto &slot = built->slots[i];
+      if (slot.row == 0) {
+        slot = {hash, static_cast<uint32_t>(row + 1)};
+        break;
+      }
+      if (slot.hash == hash && key(slot.row - 1) == key(row)) {
+        break; // Duplicate key, the first entry is kept
+      }
+    }
+  }
+  lookup = built;
+  return built;
+}
+
+auto DictColumns::find(std::string_view key) const -> size_t {
+  auto built = index();
+  auto hash = hashKey(key);
+  for (auto i = hash & built->mask;; i = (i + 1) & built->mask) {
+    const auto &slot = built->slots[i];
+    if (slot.row == 0) {
+      return npos;
+    }
+    if (slot.hash == hash && this->key(slot.row - 1) == key) {
+      return slot.row - 1;
+    }
+  }
+}
+
+auto DictColumns::toDicts() const -> std::vector<Dict> {
+  std::vector<Dict> dictionary;
+  dictionary.reserve(size());
+  for (size_t i = 0; i < size(); ++i) {
+    dictionary.push_back({std::string(key(i)), std::string(value(i))});
+  }
+  return dictionary;
+}
+
+auto toColumns(const std::vector<Dict> &dictionary) -> DictColumns {
+  DictColumns columns;
+  size_t keyBytes = 0;
+  size_t valueBytes = 0;
+  for (const auto &[key, value] : dictionary) {
+    keyBytes += key.size();
+    valueBytes += value.size();
+  }
+  columns.reserve(dictionary.size(), std::max(keyBytes, valueBytes));
+  for (const auto &[key, value] : dictionary) {
+    columns.push_back(key, value);
+  }
+  return columns;
+}
+
+auto process_columns(std::string_view input)
+    -> std::variant<DictColumns, bool> {
+  // First check
+  if (input.empty()) {
+    return false; // Unable to parse
+  }
+
+  auto elements = group_elements(input);
+  if (elements.empty()) {
+    return true; // Empty group
+  }
+
+  DictColumns columns;
+  columns.reserve(elements.size(), input.size());
+  for (auto e : elements) {
+    auto element = process_element(e);
+    auto *dict = std::get_if<DictView>(&element);
+    if (dict == nullptr) {
+      return false; // Not a group of dictionaries
+    }
+    columns.push_back(dict->key, dict->value);
+  }
+  return columns;
+}
@@ -0,0 +1,85 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Columnar dictionaries: all keys in one buffer and all values in another,
+ * each with an offset array (the Arrow string column layout), instead of two
+ * strings per entry. Key lookups use a hash index built on first use.
+ */
+#pragma once
+
+#include "typeParser.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// One string column: entry i is bytes[offsets[i], offsets[i + 1])
+struct StringColumn {
+  std::string bytes;
+  std::vector<uint32_t> offsets{0};
+
+  auto size() const -> size_t { return offsets.size() - 1; }
+
+  auto operator[](size_t index) const -> std::string_view {
+    return std::string_view(bytes).substr(
+        offsets[index], offsets[index + 1] - offsets[index]);
+  }
+
+  auto operator==(const StringColumn &) const -> bool = default;
+};
+
+class DictColumns {
+public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  DictColumns() = default;
+  DictColumns(const DictColumns &other);
+  DictColumns(DictColumns &&other) noexcept;
+  auto operator=(const DictColumns &other) -> DictColumns &;
+  auto operator=(DictColumns &&other) noexcept -> DictColumns &;
+
+  // Function reserves room for 'entries' entries of 'bytes' bytes in total
+  void reserve(size_t entries, size_t bytes);
+
+  // Function appends an entry, spaces removed as in Dict (throws
+  // std::length_error beyond 4 GiB per column, nothing appended then)
+  void push_back(std::string_view key, std::string_view value);
+
+  auto size() const -> size_t { return keyColumn.size(); }
+  auto empty() const -> bool { return size() == 0; }
+
+  auto key(size_t index) const -> std::string_view { return keyColumn[index]; }
+  auto value(size_t index) const -> std::string_view {
+    return valueColumn[index];
+  }
+
+  auto keys() const -> const StringColumn & { return keyColumn; }
+  auto values() const -> const StringColumn & { return valueColumn; }
+
+  // Function returns the index of the first entry with this key (npos when
+  // missing). The index is built by the first call, safe from any thread.
+  auto find(std::string_view key) const -> size_t;
+
+  // Function converts to one Dict per entry
+  auto toDicts() const -> std::vector<Dict>;
+
+  auto operator==(const DictColumns &other) const -> bool {
+    return keyColumn == other.keyColumn && valueColumn == other.valueColumn;
+  }
+
+private:
+  struct Index;
+
+  auto index() const -> std::shared_ptr<const Index>;
+
+  StringColumn keyColumn;
+  StringColumn valueColumn;
+  mutable std::atomic<std::shared_ptr<const Index>> lookup;
+};
+
+// Function converts dictionaries to columns
+auto toColumns(const std::vector<Dict> &dictionary) -> DictColumns;
+
+// Process a group of dictionaries straight into columns (true for an empty
+// group, false when unable to parse or not every element is a dictionary)
+auto process_columns(std::string_view input) -> std::variant<DictColumns, bool>;
@@ -0,0 +1,117 @@
+#include "typeInstrument.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+namespace {
+
+auto reportSink() -> std::atomic<std::shared_ptr<const ReportSink>> & {
+  static std::atomic<std::shared_ptr<const ReportSink>> sink;
+  return sink;
+}
+
+thread_local AllocationCounters allocated;
+
+} // namespace
+
+void set_report_sink(ReportSink sink) {
+  reportSink().store(
+      sink ? std::make_shared<const ReportSink>(std::move(sink)) : nullptr);
+}
+
+void LatencyHistogram::add(std::chrono::nanoseconds latency) {
+  auto ns = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 1));
+  auto bucket = std::min<size_t>(std::bit_width(ns) - 1, bucket_count - 1);
+  buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::count() const -> size_t {
+  size_t total = 0;
+  for (const auto &bucket : buckets) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+auto LatencyHistogram::percentile(double fraction) const
+    -> std::chrono::nanoseconds {
+  auto total = count();
+  auto rank = static_cast<size_t>(fraction * static_cast<double>(total));
+  size_t seen = 0;
+  for (size_t i = 0; i < bucket_count; ++i) {
+    seen += buckets[i].load(std::memory_order_relaxed);
+    if (seen > rank || (seen == total && total > 0)) {
+      return std::chrono::nanoseconds(int64_t{2} << i); // Bucket upper bound
+    }
+  }
+  return std::chrono::nanoseconds(0);
+}
+
+auto LatencyHistogram::sink() -> ReportSink {
+  return [this](const ParseReport &report) { add(report.total); };
+}
+
+auto thread_allocations() -> AllocationCounters { return allocated; }
+
+void count_allocation(size_t bytes) {
+  ++allocated.count;
+  allocated.bytes += bytes;
+}
+
+#ifdef TYPE_PARSER_INSTRUMENT
+
+namespace {
+
+struct Current {
+  bool active = false;
+  ParseReport report;
+  std::chrono::steady_clock::time_point start;
+  AllocationCounters before;
+};
+
+thread_local Current current;
+
+} // namespace
+
+CallScope::CallScope(std::string_view function, std::string_view input) {
+  if (current.active || !reportSink().load()) {
+    return; // Nested call, or nobody listening
+  }
+  outermost = true;
+  current.active = true;
+  current.report = {function, input.size()};
+  current.before = allocated;
+  current.start = std::chrono::steady_clock::now();
+}
+
+CallScope::~CallScope() {
+  if (!outermost) {
+    return;
+  }
+  auto end = std::chrono::steady_clock::now();
+  current.active = false;
+  auto &report = current.report;
+  report.total = end - current.start;
+  report.allocations = allocated.count - current.before.count;
+  report.allocated_bytes = allocated.bytes - current.before.bytes;
+  if (auto sink = reportSink().load()) {
+    (*sink)(report);
+  }
+}
+
+void CallScope::elements(size_t count) {
+  if (current.active) {
+    current.report.elements = count;
+  }
+}
+
+StageTimer::~StageTimer() {
+  if (current.active) {
+    current.report.stages[static_cast<size_t>(stage)] +=
+        std::chrono::steady_clock::now() - start;
+  }
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Opt-in instrumentation of process(): time spent in each stage, and number
+ * and bytes of allocations, reported per call to a sink. Enabled by building
+ * with TYPE_PARSER_INSTRUMENT (CMake option of the same name); otherwise the
+ * timers are empty classes and nothing is measured or reported.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+#ifdef TYPE_PARSER_INSTRUMENT
+constexpr bool instrumentation_enabled = true;
+#else
+constexpr bool instrumentation_enabled = false;
+#endif
+
+// Select: choosing the result type from the converted elements, copies of
+// the result excluded
+enum class Stage { Trim, Group, Split, Classify, Convert, Select };
+
+constexpr size_t stage_count = 6;
+
+// Measures of one call of process() (or process_view, or the arena overload)
+struct ParseReport {
+  std::string_view function;
+  size_t bytes = 0; // of the input
+  size_t elements = 0;
+  std::array<std::chrono::nanoseconds, stage_count> stages{};
+  std::chrono::nanoseconds total{0};
+  size_t allocations = 0;
+  size_t allocated_bytes = 0;
+
+  auto stage(Stage s) const -> std::chrono::nanoseconds {
+    return stages[static_cast<size_t>(s)];
+  }
+};
+
+using ReportSink = std::function<void(const ParseReport &)>;
+
+// Function installs the sink called after each call (empty to stop); it may
+// be called from several threads at once
+void set_report_sink(ReportSink sink);
+
+// Latencies in power-of-two buckets of nanoseconds, safe to fill from
+// several threads
+class LatencyHistogram {
+public:
+  static constexpr size_t bucket_count = 48;
+
+  void add(std::chrono::nanoseconds latency);
+
+  auto count() const -> size_t;
+
+  // Upper bound of the bucket holding the 'fraction' quantile (0.99: p99)
+  auto percentile(double fraction) const -> std::chrono::nanoseconds;
+
+  // Sink adding the total time of each call
+  auto sink() -> ReportSink;
+
+private:
+  std::array<std::atomic<size_t>, bucket_count> buckets{};
+};
+
+// Allocations made by the calling thread since it started. Counted only in
+// programs linking typeAllocations.cpp, which replaces the global operator
+// new; the library itself never does (CMake adds it to the instrumented
+// typeParser, test and bench executables).
+struct AllocationCounters {
+  size_t count = 0;
+  size_t bytes = 0;
+};
+
+auto thread_allocations() -> AllocationCounters;
+
+// Function adds an allocation to the calling thread (see typeAllocations.cpp)
+void count_allocation(size_t bytes);
+
+#ifdef TYPE_PARSER_INSTRUMENT
+
+// Reports the enclosing call when it ends (the outermost one only)
+class CallScope {
+public:
+  CallScope(std::string_view function, std::string_view input);
+  ~CallScope();
+  CallScope(const CallScope &) = delete;
+  auto operator=(const CallScope &) -> CallScope & = delete;
+
+  // Function sets the number of elements of the current call
+  static void elements(size_t count);
+
+private:
+  bool outermost = false;
+};
+
+// Adds the time until its end to a stage of the current call
+class StageTimer {
+public:
+  explicit StageTimer(Stage stage)
+      : stage(stage), start(std::chrono::steady_clock::now()) {}
+  ~StageTimer();
+  StageTimer(const StageTimer &) = delete;
+  auto operator=(const StageTimer &) -> StageTimer & = delete;
+
+private:
+  Stage stage;
+  std::chrono::steady_clock::time_point start;
+};
+
+#else
+
+// Compiled out: nothing stored, nothing called
+class CallScope {
+public:
+  CallScope(std::string_view, std::string_view) {}
+  static void elements(size_t) {}
+};
+
+class StageTimer {
+public:
+  explicit StageTimer(Stage) {}
+};
+
+#endif
@@ -0,0 +1,489 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Compile-time parsing of group literals:
+ *   constexpr auto values = parse_literal<"{1, 2, 3}">(); // std::array<int, 3>
+ * The element scanners are shared with the runtime parser (typeParser.cpp).
+ */
+#pragma once
+
+#include "typeParser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+// --- Scanners (shared by the runtime and compile-time parsers) ---
+namespace detail {
+
+constexpr auto isDigit(char c) -> bool { return c >= '0' && c <= '9'; }
+
+constexpr auto isSpace(char c) -> bool {
+  return WHITESPACE.find(c) != std::string_view::npos;
+}
+
+constexpr auto isLineBreak(char c) -> bool { return c == '\n' || c == '\r'; }
+
+// Same as trim_view, without the vectorized scanning
+constexpr auto trimLiteral(std::string_view input,
+                           std::string_view chars = WHITESPACE)
+    -> std::string_view {
+  auto first = input.find_first_not_of(chars);
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return input.substr(first, input.find_last_not_of(chars) - first + 1);
+}
+
+// Shape of a number, spaces ignored: [prefix] body, where prefix is one of
+// "", "+", "-", "++", "+-" and body has digits and at most one dot.
+struct NumberShape {
+  bool valid = false;
+  bool negative = false;
+  bool doublePlus = false; // "++" keeps one '+' after normalization
+  bool leadingDot = false;
+  size_t dots = 0;
+
+  // isInteger(isNumber(input).value) would succeed
+  constexpr auto integer() const -> bool { return valid && dots == 0; }
+
+  // isFloat(isNumber(input).value) would succeed
+  constexpr auto fractional() const -> bool { return valid && dots == 1; }
+};
+
+constexpr auto scanNumber(std::string_view input) -> NumberShape {
+  NumberShape shape;
+  size_t signs = 0;
+  size_t digits = 0;
+  bool inBody = false;
+  for (char c : input) {
+    if (c == ' ') {
+      continue;
+    }
+    if (!inBody && (c == '+' || c == '-')) {
+      if (signs == 1 && (shape.negative || shape.doublePlus)) {
+        return {}; // "-+", "--"
+      }
+      if (signs == 2) {
+        return {};
+      }
+      shape.doublePlus = signs == 1 && c == '+';
+      shape.negative = shape.negative || c == '-';
+      ++signs;
+      continue;
+    }
+    if (isDigit(c)) {
+      ++digits;
+    } else if (c == '.') {
+      shape.leadingDot = shape.leadingDot || !inBody;
+      if (++shape.dots > 1) {
+        return {};
+      }
+    } else {
+      return {};
+    }
+    inBody = true;
+  }
+  shape.valid = digits > 0;
+  return shape;
+}
+
+// Spaces ignored: starts with 'open', ends with 'close', no line break inside
+constexpr auto isEnclosed(std::string_view input, char open, char close)
+    -> bool {
+  auto first = input.find_first_not_of(' ');
+  auto last = input.find_last_not_of(' ');
+  if (first == std::string_view::npos || first == last ||
+      input[first] != open || input[last] != close) {
+    return false;
+  }
+  return std::ranges::none_of(input.substr(first + 1, last - first - 1),
+                              isLineBreak);
+}
+
+// Spaces ignored: 'key' [whitespace] ':' value, the same language as
+// "^\\'.+'\\s*:\\s*'?.*'?$"
+constexpr auto isKeyValue(std::string_view input) -> bool {
+  auto first = input.find_first_not_of(' ');
+  if (first == std::string_view::npos || input[first] != '\'') {
+    return false;
+  }
+
+  // Line breaks after ':' are only accepted in the leading whitespace
+  auto lastBreak = input.find_last_of("\n\r");
+  size_t valueStart = 0;
+  if (lastBreak != std::string_view::npos) {
+    valueStart = lastBreak;
+    while (valueStart > 0 && isSpace(input[valueStart - 1])) {
+      --valueStart;
+    }
+  }
+
+  size_t keyLength = 0;
+  for (size_t i = first + 1; i < input.size(); ++i) {
+    char c = input[i];
+    if (isLineBreak(c)) {
+      return false;
+    }
+    if (c == '\'' && keyLength > 0) {
+      size_t colon = i + 1;
+      while (colon < input.size() && isSpace(input[colon])) {
+        ++colon;
+      }
+      if (colon < input.size() && input[colon] == ':' &&
+          (lastBreak == std::string_view::npos || colon + 1 >= valueStart)) {
+        return true;
+      }
+    }
+    if (c != ' ') {
+      ++keyLength;
+    }
+  }
+  return false;
+}
+
+// Class of an element already trimmed of whitespace (see classify)
+constexpr auto classifyTrimmed(std::string_view element) -> Kind {
+  if (element.empty()) {
+    return Kind::Invalid;
+  }
+  auto number = scanNumber(element);
+  if (number.integer()) {
+    return Kind::Integer;
+  }
+  if (number.fractional()) {
+    return Kind::Float;
+  }
+  if (isKeyValue(element)) {
+    return Kind::Dictionary;
+  }
+  auto unquoted = element.find_first_not_of('\'');
+  if (unquoted != std::string_view::npos &&
+      unquoted == element.find_last_not_of('\'')) {
+    return Kind::Character;
+  }
+  if (isEnclosed(element, '\'', '\'')) {
+    return Kind::String;
+  }
+  return Kind::Invalid;
+}
+
+// Key and value of a dictionary element, exactly one ':' and a quoted key
+constexpr auto splitKeyValue(std::string_view input)
+    -> std::variant<DictView, bool> {
+  auto colon = input.find(':');
+  if (colon == std::string_view::npos ||
+      input.find(':', colon + 1) != std::string_view::npos) {
+    return false;
+  }
+  auto key = input.substr(0, colon);
+  if (scanNumber(key).valid || !isEnclosed(key, '\'', '\'')) {
+    return false;
+  }
+  return DictView{trimLiteral(key, " "),
+                  trimLiteral(input.substr(colon + 1), " ")};
+}
+
+// --- Compile-time conversions ---
+
+// Digits and dot of a number, as parseNumber reads them
+struct Decimal {
+  bool valid = false;
+  bool negative = false;
+  unsigned long long mantissa = 0; // all digits, dot removed
+  int scale = 0;                   // digits after the dot
+  size_t digits = 0;               // significant digits in 'mantissa'
+};
+
+constexpr auto toDecimal(std::string_view input) -> Decimal {
+  auto shape = scanNumber(input);
+  Decimal decimal{shape.valid, shape.negative};
+  bool fraction = false;
+  for (char c : input) {
+    if (c == '.') {
+      fraction = true;
+    } else if (isDigit(c)) {
+      if (decimal.digits >= 19) {
+        return {}; // Beyond the exact range of the mantissa
+      }
+      decimal.mantissa = decimal.mantissa * 10 + static_cast<unsigned>(c - '0');
+      decimal.digits += decimal.mantissa != 0;
+      decimal.scale += fraction;
+    }
+  }
+  // Trailing zeros of the fraction do not change the value
+  while (decimal.scale > 0 && decimal.mantissa % 10 == 0) {
+    decimal.mantissa /= 10;
+    --decimal.scale;
+    decimal.digits -= decimal.digits > 0;
+  }
+  return decimal;
+}
+
+// Same value as stringviewToNumber<int>: fails outside the int range
+constexpr auto toInteger(std::string_view input) -> std::variant<int, bool> {
+  auto decimal = toDecimal(input);
+  constexpr auto max = static_cast<unsigned long long>(
+      std::numeric_limits<int>::max());
+  if (!decimal.valid || decimal.mantissa > max + decimal.negative) {
+    return false;
+  }
+  auto value = static_cast<long long>(decimal.mantissa);
+  return static_cast<int>(decimal.negative ? -value : value);
+}
+
+// Unsigned 128-bit integer, enough for the exact quotients of toReal
+struct Wide {
+  unsigned long long high = 0;
+  unsigned long long low = 0;
+
+  constexpr auto operator<=>(const Wide &) const = default;
+
+  constexpr auto operator+(const Wide &other) const -> Wide {
+    return {high + other.high + (low + other.low < low), low + other.low};
+  }
+
+  constexpr auto operator-(const Wide &other) const -> Wide {
+    return {high - other.high - (low < other.low), low - other.low};
+  }
+
+  constexpr auto shifted(int bits) const -> Wide { // left, bits < 128
+    if (bits == 0) {
+      return *this;
+    }
+    if (bits >= 64) {
+      return {low << (bits - 64), 0};
+    }
+    return {high << bits | low >> (64 - bits), low << bits};
+  }
+};
+
+// Same value as stringviewToNumber<float>: an int when the value is whole.
+// Correctly rounded (to nearest, ties to even) like from_chars: the 24-bit
+// significand is the exact quotient mantissa * 2^-e / 10^scale. Literals
+// beyond 19 digits or 30 decimals are rejected.
+constexpr auto toReal(std::string_view input)
+    -> std::variant<int, float, bool> {
+  auto decimal = toDecimal(input);
+  if (!decimal.valid || decimal.scale > 30) {
+    return false;
+  }
+  if (decimal.mantissa == 0) {
+    return 0;
+  }
+  Wide numerator{0, decimal.mantissa};
+  Wide denominator{0, 1};
+  for (int i = 0; i < decimal.scale; ++i) {
+    denominator = denominator.shifted(3) + denominator.shifted(1);
+  }
+
+  // Binary exponent such that 2^23 <= numerator / denominator < 2^24
+  int exponent = 0;
+  while (numerator < denominator.shifted(23)) {
+    numerator = numerator.shifted(1);
+    --exponent;
+  }
+  while (numerator >= denominator.shifted(24)) {
+    denominator = denominator.shifted(1);
+    ++exponent;
+  }
+  unsigned long significand = 0;
+  for (int bit = 23; bit >= 0; --bit) {
+    auto part = denominator.shifted(bit);
+    if (numerator >= part) {
+      numerator = numerator - part;
+      significand |= 1ul << bit;
+    }
+  }
+  auto twice = numerator.shifted(1); // remainder against half the divisor
+  if (twice > denominator || (twice == denominator && (significand & 1))) {
+    ++significand; // 2^24 at most, still exact
+  }
+
+  // Powers of two are exact in the range reachable here
+  auto value = static_cast<float>(significand);
+  for (; exponent < 0; ++exponent) {
+    value /= 2;
+  }
+  for (; exponent > 0; --exponent) {
+    value *= 2;
+  }
+  if (decimal.negative) {
+    value = -value;
+  }
+  // Whole values are returned as int, as stringviewToNumber does
+  if (value >= -2147483648.0f && value < 2147483648.0f &&
+      value == static_cast<float>(static_cast<int>(value))) {
+    return static_cast<int>(value);
+  }
+  return value;
+}
+
+// Same as process_element, usable in constant expressions
+constexpr auto literalElement(std::string_view element) -> ElementView {
+  auto trimmed = trimLiteral(element);
+  switch (classifyTrimmed(trimmed)) {
+  case Kind::Integer: {
+    auto number = toInteger(trimmed);
+    if (std::holds_alternative<int>(number)) {
+      return std::get<int>(number);
+    }
+    break;
+  }
+  case Kind::Float: {
+    auto number = toReal(trimmed);
+    if (std::holds_alternative<float>(number)) {
+      return std::get<float>(number);
+    }
+    if (std::holds_alternative<int>(number)) {
+      return std::get<int>(number);
+    }
+    break;
+  }
+  case Kind::Dictionary: {
+    auto dict = splitKeyValue(trimmed);
+    if (std::holds_alternative<DictView>(dict)) {
+      return std::get<DictView>(dict);
+    }
+    break;
+  }
+  case Kind::Character:
+    return ElementView(std::in_place_type<char>, trimLiteral(trimmed, "'")[0]);
+  case Kind::String:
+    return trimLiteral(trimmed, "'");
+  case Kind::Invalid:
+    break;
+  }
+  return false; // Unable to parse
+}
+
+// Calls fn(element) for each element of the group (see group_elements)
+template <class Fn>
+constexpr void forEachElement(std::string_view input, Fn &&fn) {
+  auto trimmed = trimLiteral(input);
+  if (!isEnclosed(trimmed, '{', '}')) {
+    fn(trimmed);
+    return;
+  }
+  auto content = trimmed.substr(1, trimmed.size() - 2);
+  size_t start = 0;
+  for (auto end = content.find(','); end != std::string_view::npos;
+       end = content.find(',', start)) {
+    fn(content.substr(start, end - start));
+    start = end + 1;
+  }
+  if (start < content.size()) {
+    fn(content.substr(start));
+  }
+}
+
+// Type of the result, same rules as process() (Integer to Dictionary in the
+// order of the ElementView alternatives)
+enum class LiteralType {
+  Failed,
+  Empty,
+  Integer,
+  Float, // floats, or integers and floats
+  Character,
+  String,
+  Dictionary,
+  Elements // strings mixed with others: the raw elements
+};
+
+struct LiteralInfo {
+  LiteralType type = LiteralType::Failed;
+  size_t size = 0;
+  size_t integers = 0; // written first in a float result
+};
+
+constexpr auto literalInfo(std::string_view input) -> LiteralInfo {
+  LiteralInfo info;
+  if (input.empty()) {
+    return info; // Unable to parse
+  }
+  size_t counts[6]{}; // by ElementView alternative
+  forEachElement(input, [&](std::string_view element) {
+    ++counts[literalElement(element).index()];
+    ++info.size;
+  });
+  info.integers = counts[0];
+
+  auto all = [&info, &counts](size_t index) {
+    return counts[index] == info.size;
+  };
+  if (info.size == 0) {
+    info.type = LiteralType::Empty;
+  } else if (all(4)) {
+    info.type = LiteralType::Dictionary;
+  } else if (all(0)) {
+    info.type = LiteralType::Integer;
+  } else if (counts[0] + counts[1] == info.size) {
+    info.type = LiteralType::Float;
+  } else if (all(2)) {
+    info.type = LiteralType::Character;
+  } else if (all(3)) {
+    info.type = LiteralType::String;
+  } else if (counts[3] > 0) {
+    info.type = LiteralType::Elements;
+  }
+  return info;
+}
+
+// Not constexpr: reaching it stops the compilation
+inline void literal_unable_to_parse() {}
+
+// Text of a literal kept as a template argument
+template <size_t N> struct LiteralString {
+  char value[N]{};
+
+  consteval LiteralString(const char (&str)[N]) {
+    std::copy_n(str, N, value);
+  }
+
+  constexpr auto view() const -> std::string_view { return {value, N - 1}; }
+};
+
+} // namespace detail
+
+// Function parses a group literal at compile time. Returns a std::array of
+// the type process() would choose (int, float, char, std::string_view or
+// DictView pointing into the literal), true for an empty group; a literal
+// process() is unable to parse does not compile.
+template <detail::LiteralString Input> consteval auto parse_literal() {
+  using namespace detail;
+  constexpr std::string_view input = Input.view();
+  constexpr auto info = literalInfo(input);
+
+  if constexpr (info.type == LiteralType::Failed) {
+    literal_unable_to_parse();
+    return false;
+  } else if constexpr (info.type == LiteralType::Empty) {
+    return true;
+  } else if constexpr (info.type == LiteralType::Elements) {
+    std::array<std::string_view, info.size> result{};
+    size_t i = 0;
+    forEachElement(input, [&](std::string_view e) { result[i++] = e; });
+    return result;
+  } else {
+    // Element type, the matching alternative of ElementView
+    constexpr size_t index = static_cast<size_t>(info.type) - 2;
+    using T = std::variant_alternative_t<index, ElementView>;
+
+    std::array<T, info.size> result{};
+    size_t front = 0;
+    size_t back = info.integers; // Integers first, then floats
+    forEachElement(input, [&](std::string_view e) {
+      auto value = literalElement(e);
+      if constexpr (std::is_same_v<T, float>) {
+        if (auto *integer = std::get_if<int>(&value)) {
+          result[front++] = static_cast<float>(*integer);
+        } else {
+          result[back++] = std::get<float>(value);
+        }
+      } else {
+        result[front++] = std::get<T>(value);
+      }
+    });
+    return result;
+  }
+}
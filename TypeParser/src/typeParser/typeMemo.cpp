@@ -0,0 +1,89 @@
+#include "typeMemo.hpp"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t max_shards = 16;
+
+// FNV-1a, 64 bits
+auto hashText(std::string_view text) -> uint64_t {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : text) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return hash;
+}
+
+} // namespace
+
+ProcessCache::ProcessCache(size_t capacity) {
+  auto count = std::clamp<size_t>(capacity, 1, max_shards);
+  shardCapacity = std::max<size_t>(capacity / count, 1);
+  for (size_t i = 0; i < count; ++i) {
+    shards.push_back(std::make_unique<Shard>());
+  }
+}
+
+auto ProcessCache::shardFor(uint64_t hash) -> Shard & {
+  // High bits, the low ones pick the bucket inside the shard
+  return *shards[(hash >> 56) % shards.size()];
+}
+
+auto ProcessCache::process(std::string_view input)
+    -> std::shared_ptr<const ParsedData> {
+  auto text = trim_view(input);
+  Key key{hashText(text), text};
+  auto &shard = shardFor(key.hash);
+  {
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      hits.fetch_add(1, std::memory_order_relaxed);
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      return it->second->result;
+    }
+  }
+
+  // Parse outside the lock, callers of other inputs are not blocked
+  misses.fetch_add(1, std::memory_order_relaxed);
+  auto result = std::make_shared<const ParsedData>(::process(text));
+
+  std::lock_guard lock(shard.mutex);
+  if (auto it = shard.index.find(key); it != shard.index.end()) {
+    return it->second->result; // Another caller parsed it first
+  }
+  shard.entries.push_front({key.hash, std::string(text), result});
+  auto &entry = shard.entries.front();
+  shard.index.emplace(Key{key.hash, entry.text}, shard.entries.begin());
+  if (shard.entries.size() > shardCapacity) {
+    auto &last = shard.entries.back();
+    shard.index.erase(Key{last.hash, last.text});
+    shard.entries.pop_back();
+    evictions.fetch_add(1, std::memory_order_relaxed);
+  }
+  return result;
+}
+
+auto ProcessCache::stats() const -> MemoStats {
+  MemoStats stats{hits.load(std::memory_order_relaxed),
+                  misses.load(std::memory_order_relaxed),
+                  evictions.load(std::memory_order_relaxed), 0,
+                  shardCapacity * shards.size()};
+  for (const auto &shard : shards) {
+    std::lock_guard lock(shard->mutex);
+    stats.size += shard->entries.size();
+  }
+  return stats;
+}
+
+void ProcessCache::clear() {
+  for (auto &shard : shards) {
+    std::lock_guard lock(shard->mutex);
+    shard->index.clear();
+    shard->entries.clear();
+  }
+  hits = 0;
+  misses = 0;
+  evictions = 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Bounded LRU cache in front of process(), for inputs that repeat. Results
+ * are shared and immutable; the cache is split into shards, each with its
+ * own lock, so concurrent callers rarely wait on each other.
+ */
+#pragma once
+
+#include "typeParser.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Counters of a ProcessCache
+struct MemoStats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t evictions = 0;
+  size_t size = 0;
+  size_t capacity = 0;
+
+  auto hit_rate() const -> double {
+    auto total = hits + misses;
+    return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+  }
+};
+
+class ProcessCache {
+public:
+  // At most 'capacity' results are kept (at least one per shard)
+  explicit ProcessCache(size_t capacity = 1024);
+
+  ProcessCache(const ProcessCache &) = delete;
+  auto operator=(const ProcessCache &) -> ProcessCache & = delete;
+
+  // Same result as process(input), parsed only when not cached. Inputs
+  // differing only by surrounding whitespace share an entry.
+  auto process(std::string_view input) -> std::shared_ptr<const ParsedData>;
+
+  auto stats() const -> MemoStats;
+
+  // Function empties the cache and resets its counters
+  void clear();
+
+private:
+  using Result = std::shared_ptr<const ParsedData>;
+
+  // Hash computed once per call, the text compared on equal hashes
+  struct Key {
+    uint64_t hash;
+    std::string_view text;
+
+    auto operator==(const Key &other) const -> bool {
+      return hash == other.hash && text == other.text;
+    }
+  };
+
+  struct KeyHash {
+    auto operator()(const Key &key) const -> size_t { return key.hash; }
+  };
+
+  struct Entry {
+    uint64_t hash;
+    std::string text; // Owns the text the map key points to
+    Result result;
+  };
+
+  // Most recently used first
+  struct Shard {
+    std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+  };
+
+  auto shardFor(uint64_t hash) -> Shard &;
+
+  size_t shardCapacity;
+  std::vector<std::unique_ptr<Shard>> shards;
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+  std::atomic<size_t> evictions{0};
+};
@@ -1,29 +1,54 @@
 #include "typeParser.hpp"
-
+#include "typeInstrument.hpp"
+#include "typeLiteral.hpp"
+#include "typeScan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <shared_mutex>
+#include <unordered_map>
 
-auto trim_left(std::string_view input, std::string_view chars_to_trim)
-    -> std::string {
-  size_t first_char = input.find_first_not_of(chars_to_trim);
+auto trim_left_view(std::string_view input, std::string_view chars_to_trim)
+    -> std::string_view {
+  size_t first_char = find_not_any(input, chars_to_trim);
   if (std::string_view::npos == first_char) {
     return {};
   }
-  return std::string(input.substr(first_char));
+  return input.substr(first_char);
 }
 
-auto trim_right(std::string_view input, std::string_view chars_to_trim)
-    -> std::string {
-  size_t last_char = input.find_last_not_of(chars_to_trim);
+auto trim_right_view(std::string_view input, std::string_view chars_to_trim)
+    -> std::string_view {
+  size_t last_char = find_last_not_any(input, chars_to_trim);
   if (std::string_view::npos == last_char) {
     return {};
   }
-  return std::string(input.substr(0, last_char + 1));
+  return input.substr(0, last_char + 1);
+}
+
+auto trim_view(std::string_view input, std::string_view chars_to_trim)
+    -> std::string_view {
+  return trim_right_view(trim_left_view(input, chars_to_trim), chars_to_trim);
+}
+
+auto trim_left(std::string_view input, std::string_view chars_to_trim)
+    -> std::string {
+  return std::string(trim_left_view(input, chars_to_trim));
+}
+
+auto trim_right(std::string_view input, std::string_view chars_to_trim)
+    -> std::string {
+  return std::string(trim_right_view(input, chars_to_trim));
 }
 
 auto trim(std::string_view input, std::string_view chars_to_trim)
     -> std::string {
-  auto trimmed_left = trim_left(input, chars_to_trim);
-  return trim_right(trimmed_left, chars_to_trim);
+  return std::string(trim_view(input, chars_to_trim));
 }
 
 auto remove_char(std::string_view input, char char_to_remove) -> std::string {
@@ -39,18 +64,21 @@ auto clean(std::string_view input) -> std::string {
 
 auto split(const std::string &str, const char &delimiter)
     -> std::vector<std::string> {
-  std::vector<std::string> result;
-  std::string strTemp;
-  for (char character : str) {
-    if (character == delimiter) {
-      result.push_back(strTemp);
-      strTemp.clear();
-    } else {
-      strTemp += character;
-    }
+  auto parts = split_view(str, delimiter);
+  return {parts.begin(), parts.end()};
+}
+
+auto split_view(std::string_view sv, char delimiter)
+    -> std::vector<std::string_view> {
+  std::vector<std::string_view> result;
+  size_t start = 0;
+  for (auto end : find_all(sv, delimiter)) {
+    result.push_back(sv.substr(start, end - start));
+    start = end + 1;
   }
-  if (!strTemp.empty()) {
-    result.push_back(strTemp);
+  // Add the last part, unless it is empty
+  if (start < sv.size()) {
+    result.push_back(sv.substr(start));
   }
   return result;
 }
@@ -59,8 +87,18 @@ auto split(std::string_view sv, std::string_view delimiter)
     -> std::vector<std::string_view> {
   std::vector<std::string_view> result;
   size_t start = 0;
-  size_t end = sv.find(delimiter);
 
+  // Single character: all positions found in one pass
+  if (delimiter.size() == 1) {
+    for (auto end : find_all(sv, delimiter[0])) {
+      result.push_back(sv.substr(start, end - start));
+      start = end + 1;
+    }
+    result.push_back(sv.substr(start));
+    return result;
+  }
+
+  size_t end = sv.find(delimiter);
   while (end != std::string_view::npos) {
     result.push_back(sv.substr(start, end - start));
     start = end + delimiter.length();
@@ -71,49 +109,260 @@ auto split(std::string_view sv, std::string_view delimiter)
   return result;
 }
 
+// --- Regular expression cache ---
+namespace {
+
+// Allows lookups by std::string_view without building a key
+struct PatternHash {
+  using is_transparent = void;
+  auto operator()(std::string_view pattern) const -> size_t {
+    return std::hash<std::string_view>{}(pattern);
+  }
+};
+
+struct RegexCache {
+  std::shared_mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<const std::regex>,
+                     PatternHash, std::equal_to<>>
+      patterns;
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+  std::atomic<std::chrono::nanoseconds::rep> compile_ns{0};
+};
+
+auto regexCache() -> RegexCache & {
+  static RegexCache cache;
+  return cache;
+}
+
+// Returns the compiled pattern, compiling it on the first request.
+// Throws std::regex_error for invalid patterns (nothing is cached).
+auto compiled(std::string_view pattern) -> std::shared_ptr<const std::regex> {
+  auto &cache = regexCache();
+  {
+    std::shared_lock lock(cache.mutex);
+    auto it = cache.patterns.find(pattern);
+    if (it != cache.patterns.end()) {
+      cache.hits.fetch_add(1, std::memory_order_relaxed);
+      return it->second;
+    }
+  }
+
+  // Compile outside the lock, concurrent readers are not blocked
+  auto start = std::chrono::steady_clock::now();
+  auto rgx = std::make_shared<const std::regex>(pattern.begin(), pattern.end());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  std::unique_lock lock(cache.mutex);
+  auto [it, inserted] = cache.patterns.try_emplace(std::string(pattern), rgx);
+  if (inserted) {
+    cache.misses.fetch_add(1, std::memory_order_relaxed);
+    cache.compile_ns.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+  } else {
+    // Another thread compiled it first
+    cache.hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  return it->second;
+}
+
+} // namespace
+
 auto match(std::string_view value, std::string_view pattern) -> Data {
-  auto rgx = std::regex(std::string(pattern));
-  auto result = std::regex_match(std::string(value), rgx);
+  auto rgx = compiled(pattern);
+  auto result = std::regex_match(value.begin(), value.end(), *rgx);
   return {result, result ? std::string(value) : ""};
 }
 
-auto isNumber(std::string_view input) -> Data {
-  // Check if there is a digit
-  if (!std::regex_search(input.begin(), input.end(), std::regex("\\d"))) {
-    return {false, ""}; // It has no digit
-  }
+auto regexCacheStats() -> RegexCacheStats {
+  auto &cache = regexCache();
+  std::shared_lock lock(cache.mutex);
+  return {cache.hits.load(std::memory_order_relaxed),
+          cache.misses.load(std::memory_order_relaxed), cache.patterns.size(),
+          std::chrono::nanoseconds(
+              cache.compile_ns.load(std::memory_order_relaxed))};
+}
 
-  // Check if there is a signal or if it is fractional
-  auto str = clean(input);
-  if (str.size() >= 2) {
-    if (str.starts_with('+')) {
-      str = str.substr(1, str.length() - 1);
-    }
-    if (str.starts_with('.')) {
-      str = std::format("0{}", str);
-    }
-    if (str.at(0) == '-' && str.at(1) == '.') {
-      str = str.substr(2, str.length() - 1);
-      str = std::format("-0.{}", str);
+void clearRegexCache() {
+  auto &cache = regexCache();
+  std::unique_lock lock(cache.mutex);
+  cache.patterns.clear();
+  cache.hits = 0;
+  cache.misses = 0;
+  cache.compile_ns = 0;
+}
+
+// --- Scanners (hand-written replacements for the regular expressions) ---
+namespace {
+
+using detail::isDigit;
+using detail::isEnclosed;
+using detail::isKeyValue;
+using detail::NumberShape;
+using detail::scanNumber;
+
+// Rebuilds the number as isNumber always returned it: "+.5" -> "0.5",
+// "-.5" -> "-0.5", "5." -> "5.0"
+auto normalizeNumber(std::string_view input, const NumberShape &shape)
+    -> std::string {
+  std::string str;
+  str.reserve(input.size() + 2);
+  if (shape.doublePlus) {
+    str += '+';
+  } else if (shape.negative) {
+    str += '-';
+  }
+  if (shape.leadingDot && !shape.doublePlus) {
+    str += '0';
+  }
+  for (char c : input) {
+    if (isDigit(c) || c == '.') {
+      str += c;
     }
-    if (str.ends_with('.')) {
-      str = std::format("{}0", str);
+  }
+  if (str.ends_with('.')) {
+    str += '0';
+  }
+  return str;
+}
+
+// Same language as "^-?\\d*"
+auto matchesInteger(std::string_view value) -> bool {
+  if (value.starts_with('-')) {
+    value.remove_prefix(1);
+  }
+  return std::ranges::all_of(value, isDigit);
+}
+
+// Same language as "^[+-]?\\d+\\.\\d*$"
+auto matchesFloat(std::string_view value) -> bool {
+  if (value.starts_with('+') || value.starts_with('-')) {
+    value.remove_prefix(1);
+  }
+  auto dot = value.find('.');
+  return dot != std::string_view::npos && dot > 0 &&
+         std::ranges::all_of(value.substr(0, dot), isDigit) &&
+         std::ranges::all_of(value.substr(dot + 1), isDigit);
+}
+
+} // namespace
+
+namespace {
+
+// Digits and dot of a number without its signs and spaces. 'text' points
+// into the input, or into 'compact' when spaces had to be removed.
+struct NumberBody {
+  bool valid = false;
+  bool negative = false;
+  bool fractional = false;
+  std::string_view text;
+};
+
+// A "++" prefix reads as "+", as process() always did
+auto numberBody(std::string_view input, std::string &compact) -> NumberBody {
+  auto shape = scanNumber(input);
+  if (!shape.valid) {
+    return {};
+  }
+  auto first = input.find_first_not_of("+- ");
+  auto last = input.find_last_not_of(' ');
+  NumberBody body{true, shape.negative, shape.dots == 1,
+                  input.substr(first, last - first + 1)};
+  if (body.text.find(' ') != std::string_view::npos) {
+    // Rare: spaces inside the number are ignored
+    std::ranges::copy_if(body.text, std::back_inserter(compact),
+                         [](char c) { return c != ' '; });
+    body.text = compact;
+  }
+  return body;
+}
+
+template <class T> auto readInteger(std::string_view input, T &value) -> bool {
+  std::string compact;
+  auto body = numberBody(input, compact);
+  if (!body.valid || body.fractional) {
+    return false;
+  }
+  // Magnitude first, the negative range is one larger
+  uint64_t magnitude = 0;
+  const auto *end = body.text.data() + body.text.size();
+  auto [ptr, ec] = std::from_chars(body.text.data(), end, magnitude);
+  constexpr auto max = static_cast<uint64_t>(std::numeric_limits<T>::max());
+  if (ec != std::errc() || ptr != end || magnitude > max + body.negative) {
+    return false;
+  }
+  value = body.negative ? static_cast<T>(0 - magnitude)
+                        : static_cast<T>(magnitude);
+  return true;
+}
+
+// from_chars takes "5." and ".5" as they are (Eisel-Lemire fast path)
+template <class T> auto readReal(std::string_view input, T &value) -> bool {
+  std::string compact;
+  auto body = numberBody(input, compact);
+  if (!body.valid) {
+    return false;
+  }
+  const auto *end = body.text.data() + body.text.size();
+  auto [ptr, ec] = std::from_chars(body.text.data(), end, value);
+  if (ec != std::errc() || ptr != end) {
+    return false;
+  }
+  value = body.negative ? -value : value;
+  return true;
+}
+
+} // namespace
+
+auto parseNumber(std::string_view sv, int &value) -> bool {
+  return readInteger(sv, value);
+}
+
+auto parseNumber(std::string_view sv, int64_t &value) -> bool {
+  return readInteger(sv, value);
+}
+
+auto parseNumber(std::string_view sv, float &value) -> bool {
+  return readReal(sv, value);
+}
+
+auto parseNumber(std::string_view sv, double &value) -> bool {
+  return readReal(sv, value);
+}
+
+auto stringviewToNumber64(std::string_view sv)
+    -> std::variant<int64_t, double, bool> {
+  if (scanNumber(sv).fractional()) {
+    double real = 0;
+    if (parseNumber(sv, real)) {
+      return real;
     }
+  } else if (int64_t integer = 0; parseNumber(sv, integer)) {
+    return integer;
   }
+  return false;
+}
 
-  // Check if it is number
-  auto pattern = "^[+-]?(\\d+\\.?\\d*|\\d*\\.\\d+)$";
-  return match(str, pattern);
+auto isNumber(std::string_view input) -> Data {
+  auto shape = scanNumber(input);
+  if (!shape.valid) {
+    return {false, ""};
+  }
+  return {true, normalizeNumber(input, shape)};
 }
 
 auto isInteger(std::string_view input) -> Data {
-  auto pattern = "^-?\\d*";
-  return match(isNumber(input).value, pattern);
+  auto number = isNumber(input);
+  // As before, an empty value also satisfies the integer pattern
+  auto result = matchesInteger(number.value);
+  return {result, result ? number.value : ""};
 }
 
 auto isFloat(std::string_view input) -> Data {
-  auto pattern = "^[+-]?\\d+\\.\\d*$";
-  return match(isNumber(input).value, pattern);
+  auto number = isNumber(input);
+  auto result = matchesFloat(number.value);
+  return {result, result ? number.value : ""};
 }
 
 auto isChar(std::string_view input) -> Data {
@@ -122,18 +371,28 @@ auto isChar(std::string_view input) -> Data {
 }
 
 auto isString(std::string_view input) -> Data {
-  auto pattern = "^'.*'$";
-  return {match(clean(input), pattern).status, std::string(input)};
+  return {isEnclosed(input, '\'', '\''), std::string(input)};
 }
 
 auto isDictionary(std::string_view input) -> Data {
-  auto pattern = "^\\'.+'\\s*:\\s*'?.*'?$";
-  return match(clean(input), pattern);
+  auto result = isKeyValue(input);
+  return {result, result ? clean(input) : ""};
 }
 
 auto isGroup(std::string_view input) -> Data {
-  auto pattern = "^\\{.*\\}$";
-  return match(clean(input), pattern);
+  auto result = isEnclosed(input, '{', '}');
+  return {result, result ? clean(input) : ""};
+}
+
+auto classify(std::string_view input) -> Kind {
+  auto first = input.find_first_not_of(WHITESPACE);
+  if (first == std::string_view::npos) {
+    return Kind::Invalid;
+  }
+  auto element = input.substr(first, input.find_last_not_of(WHITESPACE) -
+                                         first + 1);
+
+  return detail::classifyTrimmed(element);
 }
 
 auto stringviewToDict(std::string_view input) -> std::variant<Dict, bool> {
@@ -196,101 +455,255 @@ void view(const ParsedData &data) {
   std::visit(visitor, data);
 }
 
-auto process(std::string_view input) -> ParsedData {
-  // First check
-  if (input.empty()) {
-    return false; // Unable to parse
-  }
+auto DictView::toDict() const -> Dict { return {clean(key), clean(value)}; }
 
-  // Trim whitespace from the input
-  auto trimmed_input = trim(input);
+void view(const ParsedView &data) { view(toOwned(data)); }
 
-  // Data structure to hold elements found, initially just the input itself
-  std::vector<std::string> elements;
-  Data data;
-
-  // 1. Check if it is a group of values
-  data = isGroup(trimmed_input);
-  if (data.status) {
-    // Remove leading '{' and trailing '}'
-    std::string content = trimmed_input.substr(1, trimmed_input.length() - 2);
-    // Split the content by comma for individual elements
-    elements = split(content, ',');
-    if (elements.empty()) {
-      return true;
-    }
-  } else {
-    // If not a group, the input itself is the single element to process
-    elements.push_back(trimmed_input);
-  }
-
-  // Vectors to collect parsed types
-  std::vector<int> integers;
-  std::vector<float> floats;
-  std::vector<char> characters;
-  std::vector<std::string> strings;
-  std::vector<Dict> dictionary;
-
-  for (auto &e : elements) {
-    auto trimmed_e = trim(e);
-
-    Data number = isNumber(trimmed_e);
-    if (number.status) {
-      data = isInteger(number.value);
-      if (data.status) {
-        auto num_variant = stringviewToNumber<int>(data.value);
-        if (std::holds_alternative<int>(num_variant)) {
-          integers.push_back(std::get<int>(num_variant));
-          continue;
-        }
-      }
-      data = isFloat(number.value);
-      if (data.status) {
-        auto num_variant = stringviewToNumber<float>(data.value);
-        if (std::holds_alternative<float>(num_variant)) {
-          floats.push_back(std::get<float>(num_variant));
-          continue;
+auto toOwned(ParsedView data) -> ParsedData {
+  const auto visitor = overloads{
+      [](std::vector<std::string_view> &vec) -> ParsedData {
+        return std::vector<std::string>(vec.begin(), vec.end());
+      },
+      [](std::vector<DictView> &vec) -> ParsedData {
+        std::vector<Dict> dictionary;
+        dictionary.reserve(vec.size());
+        for (const auto &item : vec) {
+          dictionary.push_back(item.toDict());
         }
-        if (std::holds_alternative<int>(num_variant)) {
-          integers.push_back(std::get<int>(num_variant));
-          continue;
+        return dictionary;
+      },
+      [](auto &other) -> ParsedData { return std::move(other); },
+  };
+  return std::visit(visitor, data);
+}
+
+auto toOwned(const ParsedPmr &data) -> ParsedData {
+  const auto visitor = overloads{
+      [](const std::pmr::vector<PmrDict> &vec) -> ParsedData {
+        std::vector<Dict> dictionary;
+        dictionary.reserve(vec.size());
+        for (const auto &item : vec) {
+          dictionary.push_back({std::string(item.key), std::string(item.value)});
         }
-      }
-    }
+        return dictionary;
+      },
+      [](const std::pmr::vector<std::pmr::string> &vec) -> ParsedData {
+        return std::vector<std::string>(vec.begin(), vec.end());
+      },
+      [](bool v) -> ParsedData { return v; },
+      []<class T>(const std::pmr::vector<T> &vec) -> ParsedData {
+        return std::vector<T>(vec.begin(), vec.end());
+      },
+  };
+  return std::visit(visitor, data);
+}
 
-    data = isDictionary(trimmed_e);
-    if (data.status) {
-      auto num_variant = stringviewToDict(data.value);
-      if (std::holds_alternative<Dict>(num_variant)) {
-        dictionary.push_back(std::get<Dict>(num_variant));
-      }
-      continue;
-    }
+namespace {
+
+// Key and value of a dictionary element, same rules as stringviewToDict
+auto stringviewToDictView(std::string_view input)
+    -> std::variant<DictView, bool> {
+  return detail::splitKeyValue(input);
+}
+
+} // namespace
+
+auto process_element(std::string_view element) -> ElementView {
+  std::string_view trimmed_e;
+  {
+    StageTimer timer(Stage::Trim);
+    trimmed_e = trim_view(element);
+  }
+  Kind kind;
+  {
+    StageTimer timer(Stage::Classify);
+    kind = classify(trimmed_e);
+  }
 
-    data = isChar(trim(trimmed_e, "'"));
-    if (data.status) {
-      characters.push_back(data.value[0]);
-      continue;
+  StageTimer timer(Stage::Convert);
+  switch (kind) {
+  case Kind::Integer: {
+    auto num_variant = stringviewToNumber<int>(trimmed_e);
+    if (std::holds_alternative<int>(num_variant)) {
+      return std::get<int>(num_variant);
     }
+    break;
+  }
+  case Kind::Float: {
+    auto num_variant = stringviewToNumber<float>(trimmed_e);
+    if (std::holds_alternative<float>(num_variant)) {
+      return std::get<float>(num_variant);
+    }
+    if (std::holds_alternative<int>(num_variant)) {
+      return std::get<int>(num_variant);
+    }
+    break;
+  }
+  case Kind::Dictionary: {
+    auto dict_variant = stringviewToDictView(trimmed_e);
+    if (std::holds_alternative<DictView>(dict_variant)) {
+      return std::get<DictView>(dict_variant);
+    }
+    break;
+  }
+  case Kind::Character:
+    return ElementView(std::in_place_type<char>,
+                       trim_view(trimmed_e, "'")[0]);
+  case Kind::String:
+    return trim_view(trimmed_e, "'");
+  case Kind::Invalid:
+    break;
+  }
+  return false; // Unable to parse
+}
+
+void ElementBuckets::add(const ElementView &value) {
+  const auto visitor = overloads{
+      [this](int v) { integers.push_back(v); },
+      [this](float v) { floats.push_back(v); },
+      [this](char v) { characters.push_back(v); },
+      [this](std::string_view v) { strings.push_back(v); },
+      [this](DictView v) { dictionary.push_back(v); },
+      [](bool) {},
+  };
+  std::visit(visitor, value);
+}
+
+void ElementBuckets::append(ElementBuckets &&other) {
+  auto move_into = [](auto &to, auto &from) {
+    to.insert(to.end(), from.begin(), from.end());
+  };
+  move_into(integers, other.integers);
+  move_into(floats, other.floats);
+  move_into(characters, other.characters);
+  move_into(strings, other.strings);
+  move_into(dictionary, other.dictionary);
+}
+
+namespace {
+
+// Resource for the temporaries of a fill of 'elements'
+template <class Vector>
+auto resourceFor(const Vector &elements) -> std::pmr::memory_resource * {
+  if constexpr (requires { elements.get_allocator().resource(); }) {
+    return elements.get_allocator().resource();
+  } else {
+    return std::pmr::get_default_resource();
+  }
+}
 
-    data = isString(trimmed_e);
-    if (data.status) {
-      auto s = trim(data.value, "'");
-      strings.push_back(s);
+// Splits the group content into 'elements' (see group_elements), a
+// std::vector or a std::pmr::vector filled in place
+template <class Vector>
+void groupElementsInto(std::string_view input, Vector &elements) {
+  // Trim whitespace from the input
+  std::string_view trimmed_input;
+  {
+    StageTimer timer(Stage::Trim);
+    trimmed_input = trim_view(input);
+  }
+
+  // 1. Check if it is a group of values
+  bool group;
+  {
+    StageTimer timer(Stage::Group);
+    group = isEnclosed(trimmed_input, '{', '}');
+  }
+  if (group) {
+    // Remove leading '{' and trailing '}'
+    auto content = trimmed_input.substr(1, trimmed_input.length() - 2);
+    // Split the content by comma for individual elements (as split_view)
+    StageTimer timer(Stage::Split);
+    size_t start = 0;
+    for (auto end : find_all(content, ',', resourceFor(elements))) {
+      elements.push_back(content.substr(start, end - start));
+      start = end + 1;
+    }
+    if (start < content.size()) {
+      elements.push_back(content.substr(start));
     }
+    return;
   }
 
-  size_t expectedSize = elements.size();
-  if (dictionary.size() == expectedSize) {
-    return dictionary;
+  // If not a group, the input itself is the single element to process
+  elements.push_back(trimmed_input);
+}
+
+// Result type chosen from the number of elements of each type
+enum class Pick {
+  Dictionary,
+  Integer,
+  Float,
+  Mixed, // integers and floats, as floats
+  Character,
+  String,
+  Elements, // some strings, the raw elements as strings
+  Failed
+};
+
+struct ElementCounts {
+  size_t integers = 0;
+  size_t floats = 0;
+  size_t characters = 0;
+  size_t strings = 0;
+  size_t dictionary = 0;
+};
+
+auto pick(const ElementCounts &counts, size_t expectedSize) -> Pick {
+  if (counts.dictionary == expectedSize) {
+    return Pick::Dictionary;
+  }
+  if (counts.integers == expectedSize) {
+    return Pick::Integer;
+  }
+  if (counts.floats == expectedSize) {
+    return Pick::Float;
+  }
+  if (counts.integers + counts.floats == expectedSize) {
+    return Pick::Mixed;
   }
-  if (integers.size() == expectedSize) {
-    return integers;
+  if (counts.characters == expectedSize) {
+    return Pick::Character;
   }
-  if (floats.size() == expectedSize) {
-    return floats;
+  if (counts.strings == expectedSize) {
+    return Pick::String;
   }
-  if (integers.size() + floats.size() == expectedSize) {
+  if (counts.strings > 0) {
+    return Pick::Elements;
+  }
+  return Pick::Failed;
+}
+
+} // namespace
+
+auto group_elements(std::string_view input) -> std::vector<std::string_view> {
+  std::vector<std::string_view> elements;
+  groupElementsInto(input, elements);
+  return elements;
+}
+
+auto group_elements(std::string_view input,
+                    std::pmr::memory_resource *resource)
+    -> std::pmr::vector<std::string_view> {
+  std::pmr::vector<std::string_view> elements(resource);
+  groupElementsInto(input, elements);
+  return elements;
+}
+
+auto select(ElementBuckets buckets,
+            std::span<const std::string_view> elements) -> ParsedView {
+  auto &[integers, floats, characters, strings, dictionary] = buckets;
+  ElementCounts counts{integers.size(), floats.size(), characters.size(),
+                       strings.size(), dictionary.size()};
+
+  switch (pick(counts, elements.size())) {
+  case Pick::Dictionary:
+    return std::move(dictionary);
+  case Pick::Integer:
+    return std::move(integers);
+  case Pick::Float:
+    return std::move(floats);
+  case Pick::Mixed: {
     std::vector<float> n;
     for (auto &i : integers) {
       n.push_back(i);
@@ -300,19 +713,282 @@ auto process(std::string_view input) -> ParsedData {
     }
     return n;
   }
-  if (characters.size() == expectedSize) {
-    return characters;
+  case Pick::Character:
+    return std::move(characters);
+  case Pick::String:
+    return std::move(strings);
+  case Pick::Elements:
+    return std::vector<std::string_view>(elements.begin(), elements.end());
+  case Pick::Failed:
+    break;
+  }
+  return false; // Unable to parse
+}
+
+namespace {
+
+// Single-pass type inference: keeps the narrowest type common to the elements
+// seen so far and writes each value straight into the vector returned.
+// Gives the same results as collecting buckets and calling select().
+template <class Allocator> class Inference {
+public:
+  template <class T>
+  using Vector = std::vector<
+      T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+  using Result =
+      std::variant<Vector<int>, Vector<float>, Vector<char>,
+                   Vector<std::string_view>, Vector<DictView>, bool>;
+
+  Inference(size_t expected, const Allocator &alloc)
+      : expected(expected), alloc(alloc), integers(alloc), numbers(alloc),
+        characters(alloc), strings(alloc), dictionary(alloc) {}
+
+  // Adds the next element, returns false once the result is decided
+  auto add(std::string_view element) -> bool {
+    if (state == State::Conflict) {
+      // No common type: only a string can still change the result
+      if (classify(element) == Kind::String) {
+        state = State::Elements;
+      }
+      return state != State::Elements;
+    }
+
+    const auto visitor = overloads{
+        [this](int value) { addInteger(value); },
+        [this](float value) { addFloat(value); },
+        [this](char value) {
+          if (join(State::Character)) {
+            characters.push_back(value);
+          }
+        },
+        [this](std::string_view value) {
+          if (state == State::Empty || state == State::String) {
+            state = State::String;
+            strings.push_back(value);
+          } else {
+            state = State::Elements; // Mixed with at least one string
+          }
+        },
+        [this](DictView value) {
+          if (join(State::Dictionary)) {
+            dictionary.push_back(value);
+          }
+        },
+        [this](bool) { conflict(); },
+    };
+    auto value = process_element(element);
+    StageTimer timer(Stage::Select);
+    std::visit(visitor, value);
+    return state != State::Elements;
+  }
+
+  auto finish(std::span<const std::string_view> elements) -> Result {
+    switch (state) {
+    case State::Integer:
+      return std::move(integers);
+    case State::Float:
+    case State::Number:
+      // Floats were written from the back
+      std::reverse(numbers.begin() + static_cast<std::ptrdiff_t>(front),
+                   numbers.end());
+      return std::move(numbers);
+    case State::Character:
+      return std::move(characters);
+    case State::String:
+      return std::move(strings);
+    case State::Dictionary:
+      return std::move(dictionary);
+    case State::Elements:
+      return Vector<std::string_view>(elements.begin(), elements.end(), alloc);
+    case State::Empty:
+    case State::Conflict:
+      break;
+    }
+    return false; // Unable to parse
   }
-  if (strings.size() == expectedSize) {
-    return strings;
+
+private:
+  enum class State {
+    Empty,
+    Integer,
+    Float,
+    Number, // integers and floats
+    Character,
+    String,
+    Dictionary,
+    Conflict, // no common type, fails unless a string follows
+    Elements  // strings mixed with others: the raw elements, final
+  };
+
+  // Joins a type that only combines with itself
+  auto join(State type) -> bool {
+    if (state == State::Empty) {
+      state = type;
+      reserve();
+    }
+    if (state == type) {
+      return true;
+    }
+    conflict();
+    return false;
   }
-  if (strings.size() > 0) {
-    std::vector<std::string> s;
-    for (auto &v : elements) {
-      s.push_back(v);
+
+  void conflict() {
+    state = state == State::String ? State::Elements : State::Conflict;
+  }
+
+  void reserve() {
+    switch (state) {
+    case State::Character:
+      characters.reserve(expected);
+      break;
+    case State::String:
+      strings.reserve(expected);
+      break;
+    case State::Dictionary:
+      dictionary.reserve(expected);
+      break;
+    default:
+      break;
     }
-    return s;
   }
 
-  return false; // Unable to parse
+  // Integers fill 'numbers' from the front and floats from the back, keeping
+  // the order of process(): integers first, then floats
+  void addInteger(int value) {
+    switch (state) {
+    case State::Empty:
+      state = State::Integer;
+      integers.reserve(expected);
+      [[fallthrough]];
+    case State::Integer:
+      integers.push_back(value);
+      break;
+    case State::Float:
+    case State::Number:
+      state = State::Number;
+      numbers[front++] = static_cast<float>(value);
+      break;
+    default:
+      conflict();
+    }
+  }
+
+  void addFloat(float value) {
+    switch (state) {
+    case State::Empty:
+      state = State::Float;
+      numbers.resize(expected);
+      break;
+    case State::Integer:
+      // Widen the integers already written, once
+      state = State::Number;
+      numbers.resize(expected);
+      std::ranges::copy(integers, numbers.begin());
+      front = integers.size();
+      integers = Vector<int>(alloc);
+      break;
+    case State::Float:
+    case State::Number:
+      break;
+    default:
+      conflict();
+      return;
+    }
+    numbers[expected - 1 - back++] = value;
+  }
+
+  size_t expected;
+  Allocator alloc;
+  State state = State::Empty;
+  Vector<int> integers;
+  Vector<float> numbers;
+  size_t front = 0;
+  size_t back = 0;
+  Vector<char> characters;
+  Vector<std::string_view> strings;
+  Vector<DictView> dictionary;
+};
+
+} // namespace
+
+auto process_view(std::string_view input) -> ParsedView {
+  CallScope scope("process_view", input);
+
+  // First check
+  if (input.empty()) {
+    return false; // Unable to parse
+  }
+
+  auto elements = group_elements(input);
+  CallScope::elements(elements.size());
+  if (elements.empty()) {
+    return true; // Empty group
+  }
+
+  Inference<std::allocator<std::byte>> inference(elements.size(), {});
+  for (auto e : elements) {
+    if (!inference.add(e)) {
+      break; // Decided
+    }
+  }
+  StageTimer timer(Stage::Select);
+  return inference.finish(elements);
+}
+
+auto process(std::string_view input) -> ParsedData {
+  CallScope scope("process", input);
+  return toOwned(process_view(input));
+}
+
+auto process(std::string_view input, std::pmr::memory_resource *resource)
+    -> ParsedPmr {
+  CallScope scope("process_pmr", input);
+
+  // First check
+  if (input.empty()) {
+    return false; // Unable to parse
+  }
+
+  auto elements = group_elements(input, resource);
+  CallScope::elements(elements.size());
+  if (elements.empty()) {
+    return true; // Empty group
+  }
+
+  Inference<std::pmr::polymorphic_allocator<std::byte>> inference(
+      elements.size(), resource);
+  for (auto e : elements) {
+    if (!inference.add(e)) {
+      break; // Decided
+    }
+  }
+
+  // Numbers are already in the resource, strings are copied into it
+  const auto visitor = overloads{
+      [resource](std::pmr::vector<std::string_view> &vec) -> ParsedPmr {
+        return std::pmr::vector<std::pmr::string>(vec.begin(), vec.end(),
+                                                  resource);
+      },
+      [resource](std::pmr::vector<DictView> &vec) -> ParsedPmr {
+        std::pmr::vector<PmrDict> dictionary(resource);
+        dictionary.reserve(vec.size());
+        for (const auto &[key, value] : vec) {
+          // Spaces removed, as DictView::toDict
+          auto &item = dictionary.emplace_back();
+          std::ranges::copy_if(key, std::back_inserter(item.key),
+                               [](char c) { return c != ' '; });
+          std::ranges::copy_if(value, std::back_inserter(item.value),
+                               [](char c) { return c != ' '; });
+        }
+        return dictionary;
+      },
+      [](auto &other) -> ParsedPmr { return std::move(other); },
+  };
+  auto result = [&inference, &elements] {
+    StageTimer timer(Stage::Select);
+    return inference.finish(elements);
+  }();
+  return std::visit(visitor, result);
 }
@@ -4,7 +4,11 @@
 #pragma once
 
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
 #include <print>
+#include <span>
 #include <string_view>
 #include <variant>
 #include <vector>
@@ -22,23 +26,96 @@ struct Dict {
   auto compare(Dict Other) -> bool {
     return key == Other.key && value == Other.value;
   }
+
+  auto operator==(const Dict &) const -> bool = default;
+};
+
+// Key and value pointing into the parsed input
+struct DictView {
+  std::string_view key;
+  std::string_view value;
+
+  // Owned copy, spaces removed as process() does
+  auto toDict() const -> Dict;
+
+  auto operator==(const DictView &) const -> bool = default;
+};
+
+// Key and value allocated from a memory resource (allocator-aware, so
+// std::pmr::vector passes its resource on to the strings)
+struct PmrDict {
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
+  std::pmr::string key;
+  std::pmr::string value;
+
+  explicit PmrDict(allocator_type alloc = {}) : key(alloc), value(alloc) {}
+  PmrDict(std::string_view key, std::string_view value,
+          allocator_type alloc = {})
+      : key(key, alloc), value(value, alloc) {}
+  PmrDict(const PmrDict &other, allocator_type alloc)
+      : key(other.key, alloc), value(other.value, alloc) {}
+  PmrDict(PmrDict &&other, allocator_type alloc)
+      : key(std::move(other.key), alloc), value(std::move(other.value), alloc) {
+  }
+  PmrDict(const PmrDict &) = default;
+  PmrDict(PmrDict &&) = default;
+  auto operator=(const PmrDict &) -> PmrDict & = default;
+  auto operator=(PmrDict &&) -> PmrDict & = default;
+};
+
+// Counters of the regular expression cache used by match
+struct RegexCacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t size = 0;
+  std::chrono::nanoseconds compile_time{0};
 };
 
+// Classes of elements recognized by the parser
+enum class Kind { Invalid, Integer, Float, Character, String, Dictionary };
+
 // Define a variant type for the possible return types of parsed data
 using ParsedData =
     std::variant<std::vector<int>, std::vector<float>, std::vector<char>,
                  std::vector<std::string>, std::vector<Dict>, bool>;
 
+// Same shape as ParsedData, every allocation taken from a memory resource
+using ParsedPmr =
+    std::variant<std::pmr::vector<int>, std::pmr::vector<float>,
+                 std::pmr::vector<char>, std::pmr::vector<std::pmr::string>,
+                 std::pmr::vector<PmrDict>, bool>;
+
+// Same shape as ParsedData, strings point into the caller's buffer
+using ParsedView =
+    std::variant<std::vector<int>, std::vector<float>, std::vector<char>,
+                 std::vector<std::string_view>, std::vector<DictView>, bool>;
+
 // --- Constants ---
-const std::string_view WHITESPACE = " \t\n\r\f\v";
+constexpr std::string_view WHITESPACE = " \t\n\r\f\v";
 
 // --- Helper Functions ---
 
+// Function removes characters to the left without copying
+auto trim_left_view(std::string_view input,
+                    std::string_view chars_to_trim = WHITESPACE)
+    -> std::string_view;
+
+// Function removes characters to the right without copying
+auto trim_right_view(std::string_view input,
+                     std::string_view chars_to_trim = WHITESPACE)
+    -> std::string_view;
+
+// Function removes characters at the ends without copying
+auto trim_view(std::string_view input,
+               std::string_view chars_to_trim = WHITESPACE)
+    -> std::string_view;
+
 // Function removes character to the left
 auto trim_left(std::string_view input,
                std::string_view chars_to_trim = WHITESPACE) -> std::string;
 
-// Function removes character to the left
+// Function removes character to the right
 auto trim_right(std::string_view input,
                 std::string_view chars_to_trim = WHITESPACE) -> std::string;
 
@@ -56,13 +133,24 @@ auto clean(std::string_view input) -> std::string;
 auto split(const std::string &str, const char &delimiter)
     -> std::vector<std::string>;
 
+// Funtion to split string_view by character, without copying (a trailing
+// empty part is dropped, as in split of std::string)
+auto split_view(std::string_view sv, char delimiter)
+    -> std::vector<std::string_view>;
+
 // Funtion to split string_view
 auto split(std::string_view sv, std::string_view delimiter)
     -> std::vector<std::string_view>;
 
-// Function checks regular expression
+// Function checks regular expression (each pattern is compiled only once)
 auto match(std::string_view value, std::string_view pattern) -> Data;
 
+// Function returns the counters of the regular expression cache
+auto regexCacheStats() -> RegexCacheStats;
+
+// Function empties the regular expression cache and resets its counters
+void clearRegexCache();
+
 // Function checks if string can be number
 auto isNumber(std::string_view input) -> Data;
 
@@ -84,24 +172,39 @@ auto isDictionary(std::string_view input) -> Data;
 // Function checks if string can be a set of strings
 auto isGroup(std::string_view input) -> Data;
 
+// Function classifies an element in a single scan, without regular
+// expressions (same class process() picks through the is* predicates)
+auto classify(std::string_view input) -> Kind;
+
+// Function reads a number of the isNumber grammar ("+.5", "5.", "-.5", ...)
+// straight into 'value', without building a string (false when it is not a
+// number or out of range for the type)
+auto parseNumber(std::string_view sv, int &value) -> bool;
+auto parseNumber(std::string_view sv, int64_t &value) -> bool;
+auto parseNumber(std::string_view sv, float &value) -> bool;
+auto parseNumber(std::string_view sv, double &value) -> bool;
+
 // Funtion convert string to number (integer or float)
 template <typename T>
 auto stringviewToNumber(std::string_view sv) -> std::variant<int, float, bool> {
-  auto result = isNumber(sv);
-  if (result.status) {
-    T val;
-    std::string_view s = result.value;
-    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), val);
-    if (ec == std::errc() && ptr == s.data() + s.size()) {
-      if (val == static_cast<int>(val)) {
-        return static_cast<int>(val);
-      }
-      return static_cast<float>(val);
+  T val;
+  if (parseNumber(sv, val)) {
+    // Whole values in the int range are returned as int
+    auto wide = static_cast<double>(val);
+    if (wide >= -2147483648.0 && wide < 2147483648.0 &&
+        val == static_cast<T>(static_cast<int>(val))) {
+      return static_cast<int>(val);
     }
+    return static_cast<float>(val);
   }
   return false;
 }
 
+// Function converts string to a 64-bit number: int64_t for an integer, double
+// for a fractional number (false when out of range, nothing is narrowed)
+auto stringviewToNumber64(std::string_view sv)
+    -> std::variant<int64_t, double, bool>;
+
 // Function converts string into key and value structure
 auto stringviewToDict(std::string_view input) -> std::variant<Dict, bool>;
 
@@ -113,5 +216,70 @@ template <class... Ts> struct overloads : Ts... {
 // Displays the converted dataset
 void view(const ParsedData &data);
 
+// Displays the converted dataset
+void view(const ParsedView &data);
+
 // Process input and convert type
 auto process(std::string_view input) -> ParsedData;
+
+// Value of a single element, strings point into it (false: unable to parse)
+using ElementView =
+    std::variant<int, float, char, std::string_view, DictView, bool>;
+
+// Function converts a single element of a group
+auto process_element(std::string_view element) -> ElementView;
+
+// Elements of a group collected by type, in input order
+struct ElementBuckets {
+  std::vector<int> integers;
+  std::vector<float> floats;
+  std::vector<char> characters;
+  std::vector<std::string_view> strings;
+  std::vector<DictView> dictionary;
+
+  void add(const ElementView &value);
+
+  // Appends the elements collected after these ones
+  void append(ElementBuckets &&other);
+};
+
+// Function splits a group into its elements (the input itself if it is not
+// a group)
+auto group_elements(std::string_view input) -> std::vector<std::string_view>;
+
+// Same, the list allocated from 'resource'
+auto group_elements(std::string_view input,
+                    std::pmr::memory_resource *resource)
+    -> std::pmr::vector<std::string_view>;
+
+// Function picks the result type from the elements collected
+auto select(ElementBuckets buckets, std::span<const std::string_view> elements)
+    -> ParsedView;
+
+// Process input taking every allocation from 'resource', e.g. a
+// std::pmr::monotonic_buffer_resource released in one step after use
+auto process(std::string_view input, std::pmr::memory_resource *resource)
+    -> ParsedPmr;
+
+// Process input without copying strings (input must outlive the result)
+auto process_view(std::string_view input) -> ParsedView;
+
+// Function makes owned copies of the strings of a parsed view
+auto toOwned(ParsedView data) -> ParsedData;
+
+// Function copies a result out of its memory resource
+auto toOwned(const ParsedPmr &data) -> ParsedData;
+
+// --- Parallel processing (typePool.hpp) ---
+class ThreadPool;
+
+// Process independent inputs in parallel, results keep the input order
+auto process_many(std::span<const std::string_view> inputs, ThreadPool &pool)
+    -> std::vector<ParsedData>;
+
+// Same, on a pool created for the call (threads = 0: one per core)
+auto process_many(std::span<const std::string_view> inputs, size_t threads = 0)
+    -> std::vector<ParsedData>;
+
+// Process a single large group, its elements split across the pool
+auto process_parallel(std::string_view input, ThreadPool &pool) -> ParsedData;
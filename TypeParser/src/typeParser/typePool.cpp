@@ -0,0 +1,173 @@
+#include "typePool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+ThreadPool::ThreadPool(size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    workers.emplace_back([this, i](std::stop_token stop) { run(i, stop); });
+  }
+}
+
+void ThreadPool::submit(Task task) {
+  auto &queue = *queues[next.fetch_add(1) % queues.size()];
+  // Counted before it can be taken, so take() never decrements below zero
+  queued.fetch_add(1);
+  {
+    std::lock_guard lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    // Pairs with the predicate check of sleeping workers
+    std::lock_guard lock(sleepMutex);
+  }
+  wake.notify_one();
+}
+
+void ThreadPool::parallel_for(size_t count,
+                              const std::function<void(size_t)> &task) {
+  std::mutex doneMutex;
+  std::condition_variable done;
+  size_t remaining = count;
+  std::exception_ptr failure; // First exception thrown by a task
+
+  for (size_t i = 0; i < count; ++i) {
+    submit([&, i] {
+      std::exception_ptr error;
+      try {
+        task(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard lock(doneMutex);
+      if (error && !failure) {
+        failure = error;
+      }
+      if (--remaining == 0) {
+        done.notify_all();
+      }
+    });
+  }
+
+  // Help with the queued tasks instead of only waiting
+  std::unique_lock lock(doneMutex);
+  while (remaining > 0) {
+    lock.unlock();
+    if (auto job = take(size())) {
+      job();
+      lock.lock();
+      continue;
+    }
+    lock.lock();
+    done.wait_for(lock, std::chrono::milliseconds(1),
+                  [&remaining] { return remaining == 0; });
+  }
+
+  // Only now, when no task references this frame anymore
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
+void ThreadPool::run(size_t index, std::stop_token stop) {
+  while (!stop.stop_requested()) {
+    if (auto task = take(index)) {
+      task();
+      continue;
+    }
+    std::unique_lock lock(sleepMutex);
+    wake.wait(lock, stop, [this] { return queued.load() > 0; });
+  }
+}
+
+auto ThreadPool::take(size_t index) -> Task {
+  auto count = queues.size();
+  for (size_t k = 0; k < count; ++k) {
+    auto &queue = *queues[(index + k) % count];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    Task task;
+    if (k == 0 && index < count) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    queued.fetch_sub(1);
+    return task;
+  }
+  return {};
+}
+
+namespace {
+
+// Bounds of the part 'index' of 'count' equal parts of [0, total)
+auto partRange(size_t total, size_t count, size_t index)
+    -> std::pair<size_t, size_t> {
+  return {total * index / count, total * (index + 1) / count};
+}
+
+// A few parts per worker, so the faster ones can steal the rest
+auto partCount(size_t total, const ThreadPool &pool) -> size_t {
+  return std::min(total, pool.size() * 4);
+}
+
+} // namespace
+
+auto process_many(std::span<const std::string_view> inputs, ThreadPool &pool)
+    -> std::vector<ParsedData> {
+  std::vector<ParsedData> results(inputs.size());
+  auto parts = partCount(inputs.size(), pool);
+  pool.parallel_for(parts, [&](size_t part) {
+    auto [first, last] = partRange(inputs.size(), parts, part);
+    for (auto i = first; i < last; ++i) {
+      results[i] = process(inputs[i]);
+    }
+  });
+  return results;
+}
+
+auto process_many(std::span<const std::string_view> inputs, size_t threads)
+    -> std::vector<ParsedData> {
+  ThreadPool pool(threads);
+  return process_many(inputs, pool);
+}
+
+auto process_parallel(std::string_view input, ThreadPool &pool) -> ParsedData {
+  // Below this, splitting costs more than it saves
+  constexpr size_t minimum_elements = 4096;
+
+  if (input.empty()) {
+    return false; // Unable to parse
+  }
+  auto elements = group_elements(input);
+  if (elements.size() < minimum_elements) {
+    return process(input);
+  }
+
+  // Each part collects its own buckets, merged in order at the end
+  auto parts = partCount(elements.size(), pool);
+  std::vector<ElementBuckets> collected(parts);
+  pool.parallel_for(parts, [&](size_t part) {
+    auto [first, last] = partRange(elements.size(), parts, part);
+    for (auto i = first; i < last; ++i) {
+      collected[part].add(process_element(elements[i]));
+    }
+  });
+
+  ElementBuckets buckets;
+  for (auto &part : collected) {
+    buckets.append(std::move(part));
+  }
+  return toOwned(select(std::move(buckets), elements));
+}
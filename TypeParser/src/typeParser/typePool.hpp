@@ -0,0 +1,55 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Work-stealing thread pool used by process_many and process_parallel.
+ */
+#pragma once
+
+#include "typeParser.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  // threads = 0: one per core
+  explicit ThreadPool(size_t threads = 0);
+
+  ThreadPool(const ThreadPool &) = delete;
+  auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+  // Queues a task, workers without work steal from the others
+  void submit(Task task);
+
+  // Runs task(i) for every i in [0, count) and waits for all of them.
+  // The calling thread helps, so it can also be used inside a task.
+  // If tasks throw, the first exception is rethrown after all finished.
+  void parallel_for(size_t count, const std::function<void(size_t)> &task);
+
+  auto size() const -> size_t { return queues.size(); }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void run(size_t index, std::stop_token stop);
+
+  // Own queue first (newest task), then the others (oldest task)
+  auto take(size_t index) -> Task;
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::atomic<size_t> queued{0};
+  std::atomic<size_t> next{0};
+  std::mutex sleepMutex;
+  std::condition_variable_any wake;
+  std::vector<std::jthread> workers; // Last, stopped before the queues go
+};
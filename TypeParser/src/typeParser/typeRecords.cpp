@@ -0,0 +1,203 @@
+#include "typeRecords.hpp"
+#include "typePool.hpp"
+#include "typeScan.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Lines are cut into chunks of about this size, a few per worker
+constexpr size_t chunk_bytes = size_t{256} << 10;
+
+// Whole lines [begin, end) of the input and their records
+struct Chunk {
+  size_t begin = 0;
+  size_t end = 0;
+  size_t lines = 0; // blank lines included
+  std::vector<std::pair<size_t, ParsedData>> records; // line in the chunk
+  RecordStats stats; // lines of the failures relative to the chunk
+};
+
+void parseChunk(std::string_view text, Chunk &chunk) {
+  auto part = text.substr(chunk.begin, chunk.end - chunk.begin);
+  auto breaks = find_all(part, '\n');
+  chunk.lines = breaks.size();
+  if (!part.empty() && part.back() != '\n') {
+    ++chunk.lines; // Last line of the input, without line break
+  }
+  chunk.stats.bytes = part.size();
+
+  size_t start = 0;
+  for (size_t i = 0; i < chunk.lines; ++i) {
+    auto stop = i < breaks.size() ? breaks[i] : part.size();
+    auto line = trim_view(part.substr(start, stop - start));
+    start = stop + 1;
+    if (line.empty()) {
+      ++chunk.stats.blank;
+      continue;
+    }
+    auto record = process(line);
+    ++chunk.stats.records;
+    if (auto *value = std::get_if<bool>(&record); value && !*value) {
+      if (chunk.stats.failed++ < RecordStats::max_failures) {
+        chunk.stats.failures.push_back({i, std::string(line)});
+      }
+    } else {
+      ++chunk.stats.types[record.index()];
+    }
+    chunk.records.emplace_back(i, std::move(record));
+  }
+}
+
+// Adds the counters of a chunk starting at line 'first'
+void merge(RecordStats &total, RecordStats &&part, size_t first) {
+  total.records += part.records;
+  total.blank += part.blank;
+  total.bytes += part.bytes;
+  for (size_t i = 0; i < total.types.size(); ++i) {
+    total.types[i] += part.types[i];
+  }
+  total.failed += part.failed;
+  for (auto &failure : part.failures) {
+    if (total.failures.size() == RecordStats::max_failures) {
+      break;
+    }
+    failure.line += first;
+    total.failures.push_back(std::move(failure));
+  }
+}
+
+// 'delivered' is told the end of the bytes whose records were delivered
+auto processRecords(std::string_view text, const RecordCallback &callback,
+                    ThreadPool &pool,
+                    const std::function<void(size_t)> &delivered)
+    -> RecordStats {
+  RecordStats stats;
+  size_t line = 1; // First line of the next chunk delivered
+  size_t offset = 0;
+  std::vector<Chunk> parsing;
+  std::vector<Chunk> ready;
+
+  auto deliver = [&] {
+    for (auto &chunk : ready) {
+      for (const auto &[index, record] : chunk.records) {
+        callback(line + index, record);
+      }
+      merge(stats, std::move(chunk.stats), line);
+      line += chunk.lines;
+    }
+    if (!ready.empty() && delivered) {
+      delivered(ready.back().end);
+    }
+    ready.clear();
+  };
+
+  while (offset < text.size() || !ready.empty()) {
+    parsing.clear();
+    while (parsing.size() < pool.size() * 4 && offset < text.size()) {
+      // Chunk ends after the first line break past its size
+      auto from = offset + chunk_bytes - 1;
+      auto end = from < text.size() ? find_any(text, "\n", from)
+                                    : std::string_view::npos;
+      end = end == std::string_view::npos ? text.size() : end + 1;
+      auto &chunk = parsing.emplace_back();
+      chunk.begin = offset;
+      chunk.end = end;
+      offset = end;
+    }
+
+    // Previous chunks delivered while these ones are parsed
+    pool.parallel_for(parsing.size() + 1, [&](size_t i) {
+      if (i == parsing.size()) {
+        deliver();
+      } else {
+        parseChunk(text, parsing[i]);
+      }
+    });
+    ready = std::move(parsing);
+  }
+  return stats;
+}
+
+} // namespace
+
+auto process_records(std::string_view text, const RecordCallback &callback,
+                     ThreadPool &pool) -> RecordStats {
+  return processRecords(text, callback, pool, {});
+}
+
+#ifdef _MSC_VER
+
+auto process_record_file(const std::string &path,
+                         const RecordCallback &callback, ThreadPool &pool)
+    -> std::variant<RecordStats, bool> {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::string text(std::istreambuf_iterator<char>(file), {});
+  return process_records(text, callback, pool);
+}
+
+#else
+
+auto process_record_file(const std::string &path,
+                         const RecordCallback &callback, ThreadPool &pool)
+    -> std::variant<RecordStats, bool> {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  // Pipes and terminals (e.g. /dev/stdin) cannot be mapped
+  auto size = static_cast<size_t>(info.st_size);
+  if (!S_ISREG(info.st_mode) || size == 0) {
+    ::close(fd);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      return false;
+    }
+    std::string text(std::istreambuf_iterator<char>(file), {});
+    return process_records(text, callback, pool);
+  }
+
+  void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+  ::madvise(map, size, MADV_SEQUENTIAL);
+
+  // Drop the pages whose records were delivered, so the resident memory
+  // stays bounded
+  auto *data = static_cast<char *>(map);
+  auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size_t released = 0;
+  auto release = [&](size_t end) {
+    end -= end % page;
+    if (end > released) {
+      ::madvise(data + released, end - released, MADV_DONTNEED);
+      released = end;
+    }
+  };
+
+  auto stats = processRecords({data, size}, callback, pool, release);
+  ::munmap(map, size);
+  return stats;
+}
+
+#endif
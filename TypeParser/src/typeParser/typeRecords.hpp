@@ -0,0 +1,49 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Record mode: one input per line (CSV-like files). Line breaks are found
+ * with the vectorized scan, lines are parsed in parallel chunks and the
+ * records are delivered in order while the next chunks are being parsed.
+ */
+#pragma once
+
+#include "typeParser.hpp"
+
+#include <array>
+#include <functional>
+#include <string>
+
+// Receives each record in order, 'line' counted from 1. Called from one
+// thread at a time, not necessarily the caller's.
+using RecordCallback =
+    std::function<void(size_t line, const ParsedData &record)>;
+
+// Line that could not be parsed
+struct FailedLine {
+  size_t line = 0;
+  std::string text;
+};
+
+// Summary of the records of an input
+struct RecordStats {
+  static constexpr size_t max_failures = 16;
+
+  size_t records = 0; // blank lines excluded
+  size_t blank = 0;
+  size_t bytes = 0;
+  // Records of each ParsedData type, by index (bool: empty groups)
+  std::array<size_t, std::variant_size_v<ParsedData>> types{};
+  size_t failed = 0;
+  std::vector<FailedLine> failures; // the first max_failures
+};
+
+// Function parses each line of 'text' as process() does (blank lines are
+// skipped, a failed line is delivered as false)
+auto process_records(std::string_view text, const RecordCallback &callback,
+                     ThreadPool &pool) -> RecordStats;
+
+// Function maps a file and parses its lines, pages are released once their
+// records are delivered (false: error)
+auto process_record_file(const std::string &path,
+                         const RecordCallback &callback, ThreadPool &pool)
+    -> std::variant<RecordStats, bool>;
@@ -0,0 +1,362 @@
+#include "typeScan.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define TYPE_SCAN_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Bytes searched for. Sets are short (whitespace, a delimiter or two), so the
+// scalar version compares against each byte instead of building a table.
+struct ByteSet {
+  constexpr explicit ByteSet(std::string_view bytes) : bytes(bytes) {}
+
+  auto contains(char c) const -> bool {
+    return std::ranges::find(bytes, c) != bytes.end();
+  }
+
+  // Each byte costs one comparison per block, larger sets stay scalar
+  auto vectorizable() const -> bool { return bytes.size() <= 8; }
+
+  std::string_view bytes;
+};
+
+// Classes reported by find_boundaries, in the order of Boundary
+constexpr std::array<std::string_view, 4> BOUNDARY_BYTES{",", ":", "'",
+                                                         " \t\n\r\f\v"};
+
+// --- Scalar ---
+
+auto findScalar(std::string_view input, const ByteSet &set, bool inSet,
+                size_t from) -> size_t {
+  for (size_t i = from; i < input.size(); ++i) {
+    if (set.contains(input[i]) == inSet) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+auto findLastScalar(std::string_view input, const ByteSet &set, bool inSet,
+                    size_t end) -> size_t {
+  while (end > 0) {
+    if (set.contains(input[--end]) == inSet) {
+      return end;
+    }
+  }
+  return std::string_view::npos;
+}
+
+void findAllScalar(std::string_view input, char delimiter, size_t from,
+                   std::pmr::vector<size_t> &positions) {
+  for (size_t i = from; i < input.size(); ++i) {
+    if (input[i] == delimiter) {
+      positions.push_back(i);
+    }
+  }
+}
+
+void findBoundariesScalar(std::string_view input, size_t from,
+                          std::pmr::vector<BoundaryPosition> &positions) {
+  for (size_t i = from; i < input.size(); ++i) {
+    for (size_t kind = 0; kind < BOUNDARY_BYTES.size(); ++kind) {
+      if (std::ranges::find(BOUNDARY_BYTES[kind], input[i]) !=
+          BOUNDARY_BYTES[kind].end()) {
+        positions.push_back({i, static_cast<Boundary>(kind)});
+        break;
+      }
+    }
+  }
+}
+
+#ifdef TYPE_SCAN_X86
+
+// --- Loops shared by the vector levels ---
+// Mask(p, set) returns one bit per byte of the block at p that is in the set
+
+template <auto Mask, size_t Width>
+[[gnu::always_inline]] inline auto findLoop(std::string_view input,
+                                            const ByteSet &set, bool inSet,
+                                            size_t from) -> size_t {
+  constexpr uint32_t full = Width == 32 ? 0xFFFFFFFFu : 0xFFFFu;
+  size_t i = from;
+  for (; i + Width <= input.size(); i += Width) {
+    uint32_t mask = Mask(input.data() + i, set);
+    if (!inSet) {
+      mask = ~mask & full;
+    }
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+  return findScalar(input, set, inSet, i);
+}
+
+template <auto Mask, size_t Width>
+[[gnu::always_inline]] inline auto findLastLoop(std::string_view input,
+                                                const ByteSet &set, bool inSet)
+    -> size_t {
+  constexpr uint32_t full = Width == 32 ? 0xFFFFFFFFu : 0xFFFFu;
+  size_t end = input.size();
+  for (; end >= Width; end -= Width) {
+    uint32_t mask = Mask(input.data() + end - Width, set);
+    if (!inSet) {
+      mask = ~mask & full;
+    }
+    if (mask != 0) {
+      return end - Width + (31 - std::countl_zero(mask));
+    }
+  }
+  return findLastScalar(input, set, inSet, end);
+}
+
+template <auto Mask, size_t Width>
+[[gnu::always_inline]] inline void
+findAllLoop(std::string_view input, const ByteSet &set,
+            std::pmr::vector<size_t> &positions) {
+  size_t i = 0;
+  for (; i + Width <= input.size(); i += Width) {
+    // One bit per delimiter, visited lowest first
+    for (uint32_t mask = Mask(input.data() + i, set); mask != 0;
+         mask &= mask - 1) {
+      positions.push_back(i + std::countr_zero(mask));
+    }
+  }
+  findAllScalar(input, set.bytes[0], i, positions);
+}
+
+template <auto Mask, size_t Width>
+[[gnu::always_inline]] inline void
+findBoundariesLoop(std::string_view input,
+                   std::pmr::vector<BoundaryPosition> &positions) {
+  static constexpr std::array<ByteSet, 4> sets{
+      ByteSet(BOUNDARY_BYTES[0]), ByteSet(BOUNDARY_BYTES[1]),
+      ByteSet(BOUNDARY_BYTES[2]), ByteSet(BOUNDARY_BYTES[3])};
+  size_t i = 0;
+  for (; i + Width <= input.size(); i += Width) {
+    // One mask per class from the same block, visited lowest bit first
+    const char *block = input.data() + i;
+    std::array<uint32_t, 4> masks{Mask(block, sets[0]), Mask(block, sets[1]),
+                                  Mask(block, sets[2]), Mask(block, sets[3])};
+    for (uint32_t mask = masks[0] | masks[1] | masks[2] | masks[3]; mask != 0;
+         mask &= mask - 1) {
+      auto bit = mask & -mask;
+      size_t kind = 0;
+      while ((masks[kind] & bit) == 0) {
+        ++kind;
+      }
+      positions.push_back(
+          {i + std::countr_zero(mask), static_cast<Boundary>(kind)});
+    }
+  }
+  findBoundariesScalar(input, i, positions);
+}
+
+// --- SSE2 (16 bytes) ---
+
+[[gnu::target("sse2")]] inline auto maskSse2(const char *p, const ByteSet &set)
+    -> uint32_t {
+  auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  auto hits = _mm_setzero_si128();
+  for (char c : set.bytes) {
+    hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+  }
+  return static_cast<uint32_t>(_mm_movemask_epi8(hits));
+}
+
+[[gnu::target("sse2")]] auto findSse2(std::string_view input,
+                                      const ByteSet &set, bool inSet,
+                                      size_t from) -> size_t {
+  return findLoop<maskSse2, 16>(input, set, inSet, from);
+}
+
+[[gnu::target("sse2")]] auto findLastSse2(std::string_view input,
+                                          const ByteSet &set, bool inSet)
+    -> size_t {
+  return findLastLoop<maskSse2, 16>(input, set, inSet);
+}
+
+[[gnu::target("sse2")]] void
+findAllSse2(std::string_view input, const ByteSet &set,
+           std::pmr::vector<size_t> &positions) {
+  findAllLoop<maskSse2, 16>(input, set, positions);
+}
+
+[[gnu::target("sse2")]] void
+findBoundariesSse2(std::string_view input,
+                   std::pmr::vector<BoundaryPosition> &positions) {
+  findBoundariesLoop<maskSse2, 16>(input, positions);
+}
+
+// --- AVX2 (32 bytes) ---
+
+[[gnu::target("avx2")]] inline auto maskAvx2(const char *p, const ByteSet &set)
+    -> uint32_t {
+  auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  auto hits = _mm256_setzero_si256();
+  for (char c : set.bytes) {
+    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c)));
+  }
+  return static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+}
+
+[[gnu::target("avx2")]] auto findAvx2(std::string_view input,
+                                      const ByteSet &set, bool inSet,
+                                      size_t from) -> size_t {
+  return findLoop<maskAvx2, 32>(input, set, inSet, from);
+}
+
+[[gnu::target("avx2")]] auto findLastAvx2(std::string_view input,
+                                          const ByteSet &set, bool inSet)
+    -> size_t {
+  return findLastLoop<maskAvx2, 32>(input, set, inSet);
+}
+
+[[gnu::target("avx2")]] void
+findAllAvx2(std::string_view input, const ByteSet &set,
+           std::pmr::vector<size_t> &positions) {
+  findAllLoop<maskAvx2, 32>(input, set, positions);
+}
+
+[[gnu::target("avx2")]] void
+findBoundariesAvx2(std::string_view input,
+                   std::pmr::vector<BoundaryPosition> &positions) {
+  findBoundariesLoop<maskAvx2, 32>(input, positions);
+}
+
+#endif
+
+auto detect() -> ScanLevel {
+#ifdef TYPE_SCAN_X86
+  if (__builtin_cpu_supports("avx2")) {
+    return ScanLevel::AVX2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return ScanLevel::SSE2;
+  }
+#endif
+  return ScanLevel::Scalar;
+}
+
+// Level in use. Zero (Scalar) until initialized, so calls made before that
+// are still correct.
+std::atomic<ScanLevel> currentLevel{detect()};
+
+// Level to use for this set of bytes
+auto levelFor(const ByteSet &set) -> ScanLevel {
+  return set.vectorizable() ? currentLevel.load(std::memory_order_relaxed)
+                            : ScanLevel::Scalar;
+}
+
+auto find(std::string_view input, std::string_view bytes, bool inSet,
+          size_t from) -> size_t {
+  if (from >= input.size()) {
+    return std::string_view::npos;
+  }
+  ByteSet set(bytes);
+  switch (levelFor(set)) {
+#ifdef TYPE_SCAN_X86
+  case ScanLevel::AVX2:
+    return findAvx2(input, set, inSet, from);
+  case ScanLevel::SSE2:
+    return findSse2(input, set, inSet, from);
+#endif
+  default:
+    return findScalar(input, set, inSet, from);
+  }
+}
+
+} // namespace
+
+auto detected_scan_level() -> ScanLevel {
+  static const ScanLevel level = detect();
+  return level;
+}
+
+auto scan_level() -> ScanLevel {
+  return currentLevel.load(std::memory_order_relaxed);
+}
+
+auto set_scan_level(ScanLevel level) -> ScanLevel {
+  level = std::min(level, detected_scan_level());
+  currentLevel.store(level, std::memory_order_relaxed);
+  return level;
+}
+
+auto find_any(std::string_view input, std::string_view bytes, size_t from)
+    -> size_t {
+  return find(input, bytes, true, from);
+}
+
+auto find_not_any(std::string_view input, std::string_view bytes) -> size_t {
+  // Elements are mostly trimmed already: no need to dispatch
+  if (!input.empty() && !ByteSet(bytes).contains(input.front())) {
+    return 0;
+  }
+  return find(input, bytes, false, 0);
+}
+
+auto find_last_not_any(std::string_view input, std::string_view bytes)
+    -> size_t {
+  ByteSet set(bytes);
+  if (!input.empty() && !set.contains(input.back())) {
+    return input.size() - 1;
+  }
+  switch (levelFor(set)) {
+#ifdef TYPE_SCAN_X86
+  case ScanLevel::AVX2:
+    return findLastAvx2(input, set, false);
+  case ScanLevel::SSE2:
+    return findLastSse2(input, set, false);
+#endif
+  default:
+    return findLastScalar(input, set, false, input.size());
+  }
+}
+
+auto find_all(std::string_view input, char delimiter,
+              std::pmr::memory_resource *resource)
+    -> std::pmr::vector<size_t> {
+  std::pmr::vector<size_t> positions(resource);
+  ByteSet set({&delimiter, 1});
+  switch (levelFor(set)) {
+#ifdef TYPE_SCAN_X86
+  case ScanLevel::AVX2:
+    findAllAvx2(input, set, positions);
+    break;
+  case ScanLevel::SSE2:
+    findAllSse2(input, set, positions);
+    break;
+#endif
+  default:
+    findAllScalar(input, delimiter, 0, positions);
+  }
+  return positions;
+}
+
+auto find_boundaries(std::string_view input,
+                     std::pmr::memory_resource *resource)
+    -> std::pmr::vector<BoundaryPosition> {
+  std::pmr::vector<BoundaryPosition> positions(resource);
+  switch (currentLevel.load(std::memory_order_relaxed)) {
+#ifdef TYPE_SCAN_X86
+  case ScanLevel::AVX2:
+    findBoundariesAvx2(input, positions);
+    break;
+  case ScanLevel::SSE2:
+    findBoundariesSse2(input, positions);
+    break;
+#endif
+  default:
+    findBoundariesScalar(input, 0, positions);
+  }
+  return positions;
+}
@@ -0,0 +1,62 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Byte scanning used by split and trim. On x86 the bytes are compared 16
+ * (SSE2) or 32 (AVX2) at a time, the level being chosen at runtime; other
+ * targets use the scalar version. All levels give the same results.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+enum class ScanLevel { Scalar, SSE2, AVX2 };
+
+// Byte classes that delimit the parts of a group
+enum class Boundary : uint8_t { Comma, Colon, Quote, Whitespace };
+
+struct BoundaryPosition {
+  size_t position;
+  Boundary kind;
+
+  auto operator==(const BoundaryPosition &) const -> bool = default;
+};
+
+// Function returns the best level supported by the processor
+auto detected_scan_level() -> ScanLevel;
+
+// Function returns the level in use
+auto scan_level() -> ScanLevel;
+
+// Function selects the level in use, limited to the detected one (returns the
+// level actually selected)
+auto set_scan_level(ScanLevel level) -> ScanLevel;
+
+// Function finds the first byte that is one of 'bytes', starting at 'from'
+// (same as find_first_of)
+auto find_any(std::string_view input, std::string_view bytes, size_t from = 0)
+    -> size_t;
+
+// Function finds the first byte that is not one of 'bytes'
+// (same as find_first_not_of)
+auto find_not_any(std::string_view input, std::string_view bytes) -> size_t;
+
+// Function finds the last byte that is not one of 'bytes'
+// (same as find_last_not_of)
+auto find_last_not_any(std::string_view input, std::string_view bytes)
+    -> size_t;
+
+// Function returns the positions of every 'delimiter' in a single pass
+auto find_all(std::string_view input, char delimiter,
+              std::pmr::memory_resource *resource =
+                  std::pmr::get_default_resource())
+    -> std::pmr::vector<size_t>;
+
+// Function returns the position and class of every comma, colon, quote and
+// whitespace byte, in order, in a single pass
+auto find_boundaries(std::string_view input,
+                     std::pmr::memory_resource *resource =
+                         std::pmr::get_default_resource())
+    -> std::pmr::vector<BoundaryPosition>;
@@ -0,0 +1,177 @@
+#include "typeStream.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void StreamParser::feed(std::string_view chunk) {
+  stats.bytes += chunk.size();
+
+  if (mode == Mode::Start) {
+    auto first = chunk.find_first_not_of(WHITESPACE);
+    if (first == std::string_view::npos) {
+      return; // Still leading whitespace
+    }
+    if (chunk[first] == '{') {
+      mode = Mode::Group;
+      stats.group = true;
+      chunk.remove_prefix(first + 1);
+    } else {
+      mode = Mode::Single;
+      chunk.remove_prefix(first);
+    }
+  }
+
+  if (mode == Mode::Group) {
+    for (auto comma = chunk.find(','); comma != std::string_view::npos;
+         comma = chunk.find(',')) {
+      auto part = chunk.substr(0, comma);
+      if (pending.empty()) {
+        emit(part); // Element entirely inside the chunk, no copy
+      } else {
+        pending += part;
+        emit(pending);
+        pending.clear();
+      }
+      chunk.remove_prefix(comma + 1);
+    }
+    keep(chunk);
+  } else if (mode == Mode::Single) {
+    keep(chunk);
+  }
+}
+
+auto StreamParser::finish() -> StreamStats {
+  if (mode == Mode::Group) {
+    // The last element ends at the closing '}'
+    auto last = trim_right_view(pending);
+    if (last.ends_with('}')) {
+      stats.complete = true;
+      auto element = last.substr(0, last.size() - 1);
+      if (!element.empty()) {
+        emit(element);
+      }
+    }
+  } else if (mode == Mode::Single) {
+    stats.complete = true;
+    emit(pending);
+  }
+  pending.clear();
+  mode = Mode::Done;
+  return stats;
+}
+
+void StreamParser::emit(std::string_view element) {
+  ++stats.elements;
+  callback(element, process_element(element));
+}
+
+void StreamParser::keep(std::string_view part) {
+  pending += part;
+  stats.peak_buffer = std::max(stats.peak_buffer, pending.size());
+}
+
+auto process_stream(std::istream &input, const ElementCallback &callback,
+                    size_t chunk_size) -> StreamStats {
+  StreamParser parser(callback);
+  std::vector<char> buffer(std::max<size_t>(chunk_size, 1));
+  while (input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
+         input.gcount() > 0) {
+    parser.feed({buffer.data(), static_cast<size_t>(input.gcount())});
+  }
+  return parser.finish();
+}
+
+#ifdef _MSC_VER
+
+auto process_fd(int, const ElementCallback &, size_t)
+    -> std::variant<StreamStats, bool> {
+  return false; // Not available
+}
+
+auto process_file(const std::string &path, const ElementCallback &callback)
+    -> std::variant<StreamStats, bool> {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  return process_stream(file, callback);
+}
+
+#else
+
+auto process_fd(int fd, const ElementCallback &callback, size_t chunk_size)
+    -> std::variant<StreamStats, bool> {
+  StreamParser parser(callback);
+  std::vector<char> buffer(std::max<size_t>(chunk_size, 1));
+  while (true) {
+    auto count = ::read(fd, buffer.data(), buffer.size());
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (count == 0) {
+      break;
+    }
+    parser.feed({buffer.data(), static_cast<size_t>(count)});
+  }
+  return parser.finish();
+}
+
+auto process_file(const std::string &path, const ElementCallback &callback)
+    -> std::variant<StreamStats, bool> {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  // Pipes and terminals (e.g. /dev/stdin) cannot be mapped
+  if (!S_ISREG(info.st_mode)) {
+    auto result = process_fd(fd, callback);
+    ::close(fd);
+    return result;
+  }
+
+  StreamParser parser(callback);
+  auto size = static_cast<size_t>(info.st_size);
+  if (size > 0) {
+    void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      ::close(fd);
+      return false;
+    }
+    ::madvise(map, size, MADV_SEQUENTIAL);
+
+    // Feed in windows and drop the pages already parsed, so the resident
+    // memory stays bounded (elements crossing windows are copied)
+    constexpr size_t window = size_t{1} << 20;
+    auto *data = static_cast<char *>(map);
+    for (size_t offset = 0; offset < size; offset += window) {
+      auto length = std::min(window, size - offset);
+      parser.feed({data + offset, length});
+      ::madvise(data + offset, length, MADV_DONTNEED);
+    }
+    ::munmap(map, size);
+  }
+  ::close(fd);
+  return parser.finish();
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Streaming version of process(): groups are read in chunks and each element
+ * is delivered as soon as it is complete, so memory does not grow with the
+ * size of the input.
+ */
+#pragma once
+
+#include "typeParser.hpp"
+
+#include <functional>
+#include <istream>
+#include <string>
+
+// Receives each element in order, views are only valid during the call
+using ElementCallback =
+    std::function<void(std::string_view element, const ElementView &value)>;
+
+// Summary of a streamed input
+struct StreamStats {
+  size_t elements = 0;
+  size_t bytes = 0;
+  size_t peak_buffer = 0; // largest element carried between chunks
+  bool group = false;
+  bool complete = false; // closing '}' found, or single element read
+};
+
+// Incremental parser: feed chunks as they arrive, then call finish.
+// Unlike process(), line breaks are accepted between the elements of a group.
+// Input that is not a group is a single element and is kept until finish.
+class StreamParser {
+public:
+  explicit StreamParser(ElementCallback callback)
+      : callback(std::move(callback)) {}
+
+  // Consumes the next chunk (it does not need to outlive the call)
+  void feed(std::string_view chunk);
+
+  // Delivers the last element and returns the summary
+  auto finish() -> StreamStats;
+
+private:
+  enum class Mode { Start, Group, Single, Done };
+
+  void emit(std::string_view element);
+  void keep(std::string_view part);
+
+  ElementCallback callback;
+  Mode mode = Mode::Start;
+  std::string pending; // element split between chunks
+  StreamStats stats;
+};
+
+// Function processes a stream (file, std::cin, ...) in fixed-size chunks
+auto process_stream(std::istream &input, const ElementCallback &callback,
+                    size_t chunk_size = 64 * 1024) -> StreamStats;
+
+// Function processes a file descriptor in fixed-size chunks (false: error)
+auto process_fd(int fd, const ElementCallback &callback,
+                size_t chunk_size = 64 * 1024)
+    -> std::variant<StreamStats, bool>;
+
+// Function processes a memory-mapped file, pages are released as they are
+// consumed (false: error)
+auto process_file(const std::string &path, const ElementCallback &callback)
+    -> std::variant<StreamStats, bool>;
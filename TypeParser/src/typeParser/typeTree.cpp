@@ -0,0 +1,219 @@
+#include "typeTree.hpp"
+#include "typeLiteral.hpp"
+
+#include <format>
+
+// Builds the node array while descending into the input
+class TreeParser {
+public:
+  explicit TreeParser(std::string_view input) : input(input) {}
+
+  auto parse() -> std::variant<ParseTree, bool> {
+    ParseTree tree;
+    nodes = &tree.list;
+    if (!element(0)) {
+      return false; // Unable to parse
+    }
+    skipSpace();
+    if (pos != input.size()) {
+      return false; // Text after the value
+    }
+    return tree;
+  }
+
+private:
+  // Deeper groups are rejected rather than overflowing the stack
+  static constexpr size_t max_depth = 256;
+
+  void skipSpace() {
+    while (pos < input.size() && detail::isSpace(input[pos])) {
+      ++pos;
+    }
+  }
+
+  // Next character, '\0' at the end
+  auto peek() const -> char { return pos < input.size() ? input[pos] : '\0'; }
+
+  auto open(NodeType type, std::string_view text) -> size_t {
+    nodes->push_back({type, 0, 0, text});
+    return nodes->size() - 1;
+  }
+
+  void close(size_t index) {
+    (*nodes)[index].end = static_cast<uint32_t>(nodes->size());
+  }
+
+  // element := 'key' ':' value | value
+  auto element(size_t depth) -> bool {
+    skipSpace();
+    if (peek() != '\'') {
+      return value(depth);
+    }
+    auto key = quoted();
+    skipSpace();
+    if (key.empty() || peek() != ':') {
+      return scalar(key);
+    }
+    ++pos;
+    auto index = open(NodeType::Pair, key);
+    (*nodes)[index].size = 1;
+    if (!value(depth + 1)) {
+      return false;
+    }
+    close(index);
+    return true;
+  }
+
+  // value := group | 'quoted' | bare
+  auto value(size_t depth) -> bool {
+    if (depth > max_depth) {
+      return false;
+    }
+    skipSpace();
+    switch (peek()) {
+    case '{':
+      return group(depth);
+    case '\'':
+      return scalar(quoted());
+    default:
+      return scalar(bare());
+    }
+  }
+
+  // group := '{' [element (',' element)*] '}'
+  auto group(size_t depth) -> bool {
+    auto start = pos++;
+    auto index = open(NodeType::Group, {});
+    uint32_t size = 0;
+    skipSpace();
+    if (peek() != '}') {
+      while (true) {
+        if (!element(depth + 1)) {
+          return false;
+        }
+        ++size;
+        skipSpace();
+        if (peek() == '}') {
+          break;
+        }
+        if (peek() != ',') {
+          return false; // Missing ',' or '}'
+        }
+        ++pos;
+      }
+    }
+    ++pos;
+    auto &node = (*nodes)[index];
+    node.size = size;
+    node.value = input.substr(start, pos - start);
+    close(index);
+    return true;
+  }
+
+  // Text from a quote to the next quote followed by a delimiter, so commas
+  // and colons inside do not split (empty when there is none)
+  auto quoted() -> std::string_view {
+    for (auto i = pos + 1; i < input.size(); ++i) {
+      if (detail::isLineBreak(input[i])) {
+        return {};
+      }
+      if (input[i] != '\'') {
+        continue;
+      }
+      auto next = input.find_first_not_of(' ', i + 1);
+      if (next == std::string_view::npos || input[next] == ',' ||
+          input[next] == '}' || input[next] == ':' ||
+          detail::isSpace(input[next])) {
+        auto text = input.substr(pos, i + 1 - pos);
+        pos = i + 1;
+        return text;
+      }
+    }
+    return {};
+  }
+
+  // Unquoted text up to the next delimiter
+  auto bare() -> std::string_view {
+    auto end = input.find_first_of(",}:{'", pos);
+    if (end == std::string_view::npos) {
+      end = input.size();
+    }
+    auto text = detail::trimLiteral(input.substr(pos, end - pos));
+    pos = end;
+    return text;
+  }
+
+  auto scalar(std::string_view text) -> bool {
+    if (text.empty()) {
+      return false;
+    }
+    auto add = [this](NodeType type, std::variant<int, float, char,
+                                                  std::string_view> value) {
+      nodes->push_back({type, 0, static_cast<uint32_t>(nodes->size() + 1),
+                        value});
+      return true;
+    };
+    const auto visitor = overloads{
+        [&](int v) { return add(NodeType::Integer, v); },
+        [&](float v) { return add(NodeType::Float, v); },
+        [&](char v) { return add(NodeType::Character, v); },
+        [&](std::string_view v) { return add(NodeType::String, v); },
+        [](DictView) { return false; },
+        [](bool) { return false; },
+    };
+    return std::visit(visitor, process_element(text));
+  }
+
+  std::string_view input;
+  size_t pos = 0;
+  std::vector<Node> *nodes = nullptr;
+};
+
+auto parse_tree(std::string_view input) -> std::variant<ParseTree, bool> {
+  return TreeParser(input).parse();
+}
+
+namespace {
+
+void appendNode(const ParseTree &tree, const Node &node, std::string &out) {
+  switch (node.type) {
+  case NodeType::Group: {
+    out += '{';
+    bool first = true;
+    for (const auto &child : tree.children(node)) {
+      out += first ? "" : ", ";
+      appendNode(tree, child, out);
+      first = false;
+    }
+    out += '}';
+    break;
+  }
+  case NodeType::Pair:
+    out += std::get<std::string_view>(node.value);
+    out += " : ";
+    appendNode(tree, *tree.children(node).begin(), out);
+    break;
+  case NodeType::Integer:
+    out += std::format("{}", std::get<int>(node.value));
+    break;
+  case NodeType::Float:
+    out += std::format("{}", std::get<float>(node.value));
+    break;
+  case NodeType::Character:
+    out += std::format("'{}'", std::get<char>(node.value));
+    break;
+  case NodeType::String:
+    out += std::format("'{}'", std::get<std::string_view>(node.value));
+    break;
+  }
+}
+
+} // namespace
+
+auto toString(const ParseTree &tree) -> std::string {
+  std::string out;
+  appendNode(tree, tree.root(), out);
+  return out;
+}
+
+void view(const ParseTree &tree) { std::println("{}", toString(tree)); }
@@ -0,0 +1,95 @@
+/*
+ * This code focuses on training modern C++ and manipulating types and strings.
+ *
+ * Recursive-descent parser for nested groups: {'a' : {1, 2}, 'b, c' : 'x'}.
+ * Commas and colons inside quotes do not split, dictionary values keep their
+ * type. The tree is stored in one array, each node followed by its children.
+ */
+#pragma once
+
+#include "typeParser.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+
+enum class NodeType : uint8_t {
+  Group,
+  Pair,
+  Integer,
+  Float,
+  Character,
+  String
+};
+
+// One value of a tree: Group (elements as children), Pair (key in 'value',
+// the typed value as its only child) or a scalar. 'end' is the index after
+// the last node of the subtree, so the next sibling is nodes[end].
+struct Node {
+  NodeType type = NodeType::Group;
+  uint32_t size = 0; // children
+  uint32_t end = 0;
+  std::variant<int, float, char, std::string_view> value;
+};
+
+// Iterates over the children of a node, jumping from sibling to sibling
+class ChildIterator {
+public:
+  using value_type = Node;
+  using difference_type = std::ptrdiff_t;
+
+  ChildIterator() = default;
+  ChildIterator(const Node *base, const Node *node) : base(base), node(node) {}
+
+  auto operator*() const -> const Node & { return *node; }
+  auto operator->() const -> const Node * { return node; }
+
+  auto operator++() -> ChildIterator & {
+    node = base + node->end;
+    return *this;
+  }
+
+  auto operator++(int) -> ChildIterator {
+    auto copy = *this;
+    ++*this;
+    return copy;
+  }
+
+  auto operator==(const ChildIterator &) const -> bool = default;
+
+private:
+  const Node *base = nullptr;
+  const Node *node = nullptr;
+};
+
+class ParseTree {
+public:
+  using Children = std::ranges::subrange<ChildIterator>;
+
+  // All nodes, the root first
+  auto nodes() const -> std::span<const Node> { return list; }
+
+  auto root() const -> const Node & { return list.front(); }
+
+  // Function returns the children of a node of this tree
+  auto children(const Node &node) const -> Children {
+    const auto *base = list.data();
+    return {ChildIterator(base, &node + 1),
+            ChildIterator(base, base + node.end)};
+  }
+
+private:
+  friend class TreeParser;
+
+  std::vector<Node> list;
+};
+
+// Function parses nested groups and typed dictionary values (false when
+// unable to parse). Strings point into 'input'.
+auto parse_tree(std::string_view input) -> std::variant<ParseTree, bool>;
+
+// Function writes the tree back as text, in the form of the input
+auto toString(const ParseTree &tree) -> std::string;
+
+// Function prints the tree
+void view(const ParseTree &tree);